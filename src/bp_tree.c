@@ -15,7 +15,7 @@ BPTree* bp_tree_init(BPTree* bt, const char* name) {
     BPTree* bpTree = bt ? bt : NEW(BPTree, 1);
 
     char filename[16];
-    sprintf(filename, "%s.vxl", name);
+    sprintf(filename, "%s.idx", name);
     if (access(filename, F_OK) == -1) {
         bpTree->file = fopen(filename, "w+b");
     } else {
@@ -86,3 +86,56 @@ Box* camera_aabb(Box* box, Camera* camera) {
 
     return frustum_aabb;
 }
+
+Frustum* camera_frustum(Frustum* f, Camera* camera) {
+    Frustum* frustum = f ? f : NEW(Frustum, 1);
+
+    float view[16];
+    float proj[16];
+    float clip[16];
+
+    mat4_multiply(view, camera->mat_view, camera->mat_model);
+    mat4_inverse(view, view);
+    mat4_perspective(proj, camera->fov, camera->aspect, camera->near, camera->far);
+    mat4_multiply(clip, proj, view);
+
+    // Gribb-Hartmann: each plane is the last row of the clip matrix plus or minus one of the others
+    for (int p = 0; p < 6; p++) {
+        int row = p / 2;
+        float sign = (p % 2 == 0) ? 1 : -1;
+
+        for (int i = 0; i < 4; i++) {
+            frustum->planes[p][i] = clip[i*4+3] + sign * clip[i*4+row];
+        }
+    }
+
+    return frustum;
+}
+
+char frustum_intersects_box(Frustum* frustum, Box* box) {
+    float min[3] = {
+        box->position[0],
+        box->position[1],
+        box->position[2]
+    };
+    float max[3] = {
+        box->position[0] + box->width,
+        box->position[1] + box->height,
+        box->position[2] + box->length
+    };
+
+    for (int p = 0; p < 6; p++) {
+        float* plane = frustum->planes[p];
+
+        // Test the corner furthest along the plane normal
+        float distance = plane[3];
+        for (int i = 0; i < 3; i++) {
+            distance += plane[i] * (plane[i] > 0 ? max[i] : min[i]);
+        }
+
+        if (distance < 0)
+            return 0;
+    }
+
+    return 1;
+}
@@ -25,6 +25,10 @@ typedef struct {
     float mat_proj_inv[16];
 } Camera;
 
+typedef struct {
+    float planes[6][4];
+} Frustum;
+
 Camera* camera_init(Camera* c);
 
 void camera_rotate(Camera* camera, float* axis, float radians);
@@ -32,5 +36,8 @@ void camera_move(Camera* camera, float* direction, float amount);
 void camera_set_aspect(Camera* camera, float aspect);
 
 Box* camera_aabb(Box* box, Camera* camera);
+Frustum* camera_frustum(Frustum* f, Camera* camera);
+
+char frustum_intersects_box(Frustum* frustum, Box* box);
 
 #endif // CAMERA_H
@@ -1,93 +1,165 @@
 #include "chunk.h"
 #include "internal/chunk.h"
 
-/* Linked list processing callbacks */
+/* Helpers */
+
+static const int chunk_low_faces[3]  = { WEST, BOTTOM, NORTH };
+static const int chunk_high_faces[3] = { EAST, TOP,    SOUTH };
+
+Chunk* chunk_neighbor(Chunk* chunk, Chunk** neighbors, int face) {
+    Chunk* neighbor = neighbors ? neighbors[face] : NULL;
+
+    // Only a neighbor whose boundary layer lines up with this chunk can hide its faces
+    if (neighbor) {
+        if (face == WEST || face == EAST) {
+            if (neighbor->height != chunk->height || neighbor->length != chunk->length)
+                return NULL;
+        } else if (face == BOTTOM || face == TOP) {
+            if (neighbor->width != chunk->width || neighbor->length != chunk->length)
+                return NULL;
+        } else {
+            if (neighbor->width != chunk->width || neighbor->height != chunk->height)
+                return NULL;
+        }
+    }
 
-void destroy_mesh(void* ptr) {
-    Mesh* mesh = (Mesh*)ptr;
-    mesh_destroy(mesh);
-    free(mesh);
+    return neighbor;
 }
 
-char meshes_are_equal(void* ptrA, void* ptrB) {
-    Mesh* meshA = (Mesh*)ptrA;
-    Mesh* meshB = (Mesh*)ptrB;
-
-    return meshA->color == meshB->color;
+int chunk_slice_count(Chunk* chunk) {
+    return 2 * (chunk->width + chunk->height + chunk->length);
 }
 
-void prepare_mesh(void* ptr, void* rendererPtr) {
-    Mesh* mesh = (Mesh*)ptr;
+// Slices are numbered in the order the mesher emits them: back faces then front
+// faces, along x, y and z, one slice per block layer
+int chunk_slice_index(Chunk* chunk, int b, int d, int p) {
+    int lim[3] = {
+        chunk->width,
+        chunk->height,
+        chunk->length
+    };
 
-    mesh_calc_normals(mesh);
-    mesh_buffer(mesh, MESH_FILL);
-}
+    int index = b * (lim[0] + lim[1] + lim[2]) + p;
+    for (int e = 0; e < d; e++) {
+        index += lim[e];
+    }
 
-/* Chunk */
+    return index;
+}
 
-Chunk* chunk_init(Chunk* c, int width, int height, int length) {
-    Chunk* chunk = c ? c : NEW(Chunk, 1);
+void chunk_invalidate_slice(Chunk* chunk, int b, int d, int p) {
+    int lim[3] = {
+        chunk->width,
+        chunk->height,
+        chunk->length
+    };
 
-    chunk->width = width;
-    chunk->height = height;
-    chunk->length = length;
+    if (p < 0 || p >= lim[d])
+        return;
 
-    chunk->dirty = 0;
+    char* stale = &chunk->staleSlices[chunk_slice_index(chunk, b, d, p)];
+    if (!*stale) {
+        *stale = 1;
+        chunk->stale++;
+    }
+}
 
-    linked_list_init(&chunk->meshes);
+char chunk_neighbor_active(Chunk* neighbor, int d, int layer, int* x) {
+    if (!neighbor)
+        return 0;
 
-    chunk->blocks = NEW(Block**, width);
+    int y[3] = { x[0], x[1], x[2] };
+    y[d] = layer;
 
-    for (int x=0; x<width; x++) {
-        chunk->blocks[x] = NEW(Block*, height);
+    return block_is_active(&neighbor->blocks[y[0]][y[1]][y[2]]);
+}
 
-        for (int y=0; y<height; y++) {
-            chunk->blocks[x][y] = NEW(Block, length);
+void chunk_emit_quad(Mesh* mesh, int b, int d, int* x, int h, int w, uint16_t color) {
+    int u = (d+1) % 3;
+    int v = (d+2) % 3;
 
-            for (int z=0; z<length; z++) {
-                chunk->blocks[x][y][z].data = 0;
+    int du[3] = {0, 0, 0};
+    int dv[3] = {0, 0, 0};
+    du[u] = h;
+    dv[v] = w;
+
+    Quad* quad = mesh_new_quad(mesh);
+
+    for (int k=0; k<4; k++) {
+        for (int l=0; l<3; l++) {
+            if (b) {
+                switch (k) {
+                    case 0:
+                        quad->vertices[k].position[l] = (float)x[l]+du[l]+dv[l];
+                        break;
+                    case 1:
+                        quad->vertices[k].position[l] = (float)x[l]+dv[l];
+                        break;
+                    case 2:
+                        quad->vertices[k].position[l] = (float)x[l]+du[l];
+                        break;
+                    case 3:
+                        quad->vertices[k].position[l] = (float)x[l];
+                    default:
+                        break;
+                }
+            } else {
+                switch (k) {
+                    case 0:
+                        quad->vertices[k].position[l] = (float)x[l]+du[l];
+                        break;
+                    case 1:
+                        quad->vertices[k].position[l] = (float)x[l];
+                        break;
+                    case 2:
+                        quad->vertices[k].position[l] = (float)x[l]+du[l]+dv[l];
+                        break;
+                    case 3:
+                        quad->vertices[k].position[l] = (float)x[l]+dv[l];
+                    default:
+                        break;
+                }
             }
         }
     }
 
-    return chunk;
-}
-
-void chunk_destroy(Chunk* chunk) {
-    for (int x=0; x<chunk->width; x++) {
-        for (int y=0; y<chunk->height; y++) {
-            free(chunk->blocks[x][y]);
-        }
-        free(chunk->blocks[x]);
+    if (d == 0) {
+        quad->orientation = b ? EAST  : WEST;
+    }
+    else if (d == 1) {
+        quad->orientation = b ? TOP   : BOTTOM;
+    }
+    else {
+        quad->orientation = b ? SOUTH : NORTH;
     }
-    free(chunk->blocks);
 
-    linked_list_destroy(&chunk->meshes, destroy_mesh);
+    quad->color = color;
 }
 
-void chunk_mesh(Chunk* chunk) {
-    linked_list_destroy(&chunk->meshes, destroy_mesh);
-    linked_list_init(&chunk->meshes);
-
+void chunk_mesh_masks(Chunk* chunk, Chunk** neighbors) {
     int b, d, i, j, k, l, w, h, u, v, n;
 
     int  x[3] = {0, 0, 0};
     int  q[3] = {0, 0, 0};
-    int du[3] = {0, 0, 0};
-    int dv[3] = {0, 0, 0};
     int lim[3] = {
         chunk->width,
         chunk->height,
         chunk->length
     };
 
-    uint16_t* mask;
+    // One mask serves every slice; meshing only happens on the main thread
+    static uint16_t* mask = NULL;
+    static int mask_capacity = 0;
+
+    int mask_size = MAX(lim[0] * lim[1], MAX(lim[1] * lim[2], lim[2] * lim[0]));
+    if (mask_size > mask_capacity) {
+        mask_capacity = mask_size;
+        mask = realloc(mask, mask_capacity * sizeof(uint16_t));
+    }
 
     uint16_t face;
     uint16_t face1;
 
-    int side;
-
     for (b=0; b<2; b++) {
 
         for (d=0; d<3; d++) {
@@ -104,9 +176,16 @@ void chunk_mesh(Chunk* chunk) {
             q[2] = 0;
             q[d] = 1;
 
-            for (x[d] = -1; x[d] < lim[d];) {
+            Chunk* low  = chunk_neighbor(chunk, neighbors, chunk_low_faces[d]);
+            Chunk* high = chunk_neighbor(chunk, neighbors, chunk_high_faces[d]);
 
-                mask = NEW(uint16_t, lim[u] * lim[v]);
+            int lowLayer = 0;
+            if (low) {
+                int lowLim[3] = { low->width, low->height, low->length };
+                lowLayer = lowLim[d] - 1;
+            }
+
+            for (x[d] = -1; x[d] < lim[d];) {
 
                 n = 0;
 
@@ -117,14 +196,20 @@ void chunk_mesh(Chunk* chunk) {
                             ? block_is_active(&chunk->blocks[x[0]][x[1]][x[2]])
                                 ? block_color(&chunk->blocks[x[0]][x[1]][x[2]])
                                 : -1
-                            : -1;
+                            : chunk_neighbor_active(low, d, lowLayer, x)
+                                ? 0
+                                : -1;
                         face1 = (x[d] < (lim[d] - 1))
                             ? block_is_active(&chunk->blocks[x[0]+q[0]][x[1]+q[1]][x[2]+q[2]])
                                 ? block_color(&chunk->blocks[x[0]+q[0]][x[1]+q[1]][x[2]+q[2]])
                                 : -1
-                            : -1;
+                            : chunk_neighbor_active(high, d, 0, x)
+                                ? 0
+                                : -1;
 
-                        if (face == face1 || (!b && face != (uint16_t)-1) || (b && face1 != (uint16_t)-1)) {
+                        // Neighbor blocks only ever hide faces, they never emit their own
+                        if (face == face1 || (!b && face != (uint16_t)-1) || (b && face1 != (uint16_t)-1) ||
+                            (!b && x[d] == lim[d] - 1) || (b && x[d] < 0)) {
                             mask[n++] = -1;
                         } else {
                             mask[n++] = b ? face : face1;
@@ -134,15 +219,10 @@ void chunk_mesh(Chunk* chunk) {
 
                 x[d]++;
 
-                if (d == 0) {
-                    side = b ? EAST  : WEST;
-                }
-                else if (d == 1) {
-                    side = b ? TOP   : BOTTOM;
-                }
-                else if (d == 2) {
-                    side = b ? SOUTH : NORTH;
-                }
+                // Back faces in this plane belong to the next layer, front faces to the previous one
+                int p = b ? x[d] - 1 : x[d];
+                if (p >= 0 && p < lim[d])
+                    chunk->sliceOffsets[chunk_slice_index(chunk, b, d, p)] = chunk->mesh.quads.size;
 
                 n = 0;
 
@@ -171,69 +251,7 @@ void chunk_mesh(Chunk* chunk) {
                             x[u] = j;
                             x[v] = i;
 
-                            du[0] = 0;
-                            du[1] = 0;
-                            du[2] = 0;
-                            du[u] = h;
-
-                            dv[0] = 0;
-                            dv[1] = 0;
-                            dv[2] = 0;
-                            dv[v] = w;
-
-                            Quad* quad = NEW(Quad, 1);
-
-                            for (k=0; k<4; k++) {
-                                for (l=0; l<3; l++) {
-                                    if (b) {
-                                        switch (k) {
-                                            case 0:
-                                                quad->vertices[k].position[l] = (float)x[l]+du[l]+dv[l];
-                                                break;
-                                            case 1:
-                                                quad->vertices[k].position[l] = (float)x[l]+dv[l];
-                                                break;
-                                            case 2:
-                                                quad->vertices[k].position[l] = (float)x[l]+du[l];
-                                                break;
-                                            case 3:
-                                                quad->vertices[k].position[l] = (float)x[l];
-                                            default:
-                                                break;
-                                        }
-                                    } else {
-                                        switch (k) {
-                                            case 0:
-                                                quad->vertices[k].position[l] = (float)x[l]+du[l];
-                                                break;
-                                            case 1:
-                                                quad->vertices[k].position[l] = (float)x[l];
-                                                break;
-                                            case 2:
-                                                quad->vertices[k].position[l] = (float)x[l]+du[l]+dv[l];
-                                                break;
-                                            case 3:
-                                                quad->vertices[k].position[l] = (float)x[l]+dv[l];
-                                            default:
-                                                break;
-                                        }
-                                    }
-                                }
-                            }
-
-                            quad->orientation = side;
-
-                            Mesh* mesh = NEW(Mesh, 1);
-                            mesh->color = mask[n];
-                            LinkedListNode* existingNode = linked_list_find(&chunk->meshes, mesh, meshes_are_equal);
-                            if (existingNode == NULL) {
-                                mesh_init(mesh);
-                                linked_list_insert(&chunk->meshes, mesh);
-                            } else {
-                                free(mesh);
-                                mesh = (Mesh*)existingNode->data;
-                            }
-                            mesh_add_quad(mesh, quad);
+                            chunk_emit_quad(&chunk->mesh, b, d, x, h, w, mask[n]);
 
                             for (l = 0; l < h; l++) {
                                 for (k = 0; k < w; k++) {
@@ -252,12 +270,526 @@ void chunk_mesh(Chunk* chunk) {
                         }
                     }
                 }
+            }
+        }
+    }
+}
+
+void chunk_mesh_binary(Chunk* chunk, Chunk** neighbors) {
+    int lim[3] = {
+        chunk->width,
+        chunk->height,
+        chunk->length
+    };
+
+    // Occupancy columns along each axis, one bit per block,
+    // indexed by x[u]*lim[v] + x[v] like the slice masks
+    static uint64_t columns[3][CHUNK_BINARY_MESH_MAX * CHUNK_BINARY_MESH_MAX];
+    // Visible faces of one direction, as a row of bits over v for each slice and u
+    static uint64_t rows[CHUNK_BINARY_MESH_MAX][CHUNK_BINARY_MESH_MAX];
+
+    int x[3];
+
+    for (int d = 0; d < 3; d++) {
+        memset(columns[d], 0, lim[(d+1) % 3] * lim[(d+2) % 3] * sizeof(uint64_t));
+    }
+
+    for (x[0] = 0; x[0] < lim[0]; x[0]++) {
+        for (x[1] = 0; x[1] < lim[1]; x[1]++) {
+            Block* column = chunk->blocks[x[0]][x[1]];
+
+            for (x[2] = 0; x[2] < lim[2]; x[2]++) {
+                if (!block_is_active(&column[x[2]]))
+                    continue;
+
+                for (int d = 0; d < 3; d++) {
+                    int u = (d+1) % 3;
+                    int v = (d+2) % 3;
+                    columns[d][x[u]*lim[v] + x[v]] |= (uint64_t)1 << x[d];
+                }
+            }
+        }
+    }
+
+    for (int b = 0; b < 2; b++) {
+
+        for (int d = 0; d < 3; d++) {
+
+            int u = (d+1) % 3;
+            int v = (d+2) % 3;
+
+            for (int p = 0; p < lim[d]; p++) {
+                memset(rows[p], 0, lim[u] * sizeof(uint64_t));
+            }
+
+            Chunk* neighbor = b ? chunk_neighbor(chunk, neighbors, chunk_high_faces[d])
+                                : chunk_neighbor(chunk, neighbors, chunk_low_faces[d]);
+
+            int layer = 0;
+            if (neighbor && !b) {
+                int neighborLim[3] = { neighbor->width, neighbor->height, neighbor->length };
+                layer = neighborLim[d] - 1;
+            }
+
+            // A back face shows where the previous block is empty, a front face
+            // where the next one is; past the edge, the neighbor's boundary layer decides
+            for (int j = 0; j < lim[u]; j++) {
+                for (int i = 0; i < lim[v]; i++) {
+                    uint64_t column = columns[d][j*lim[v] + i];
+                    if (!column)
+                        continue;
+
+                    x[d] = 0;
+                    x[u] = j;
+                    x[v] = i;
+
+                    uint64_t edge = chunk_neighbor_active(neighbor, d, layer, x)
+                        ? (b ? (uint64_t)1 << (lim[d] - 1) : 1)
+                        : 0;
+
+                    uint64_t faces = b ? column & ~((column >> 1) | edge) : column & ~((column << 1) | edge);
+
+                    while (faces) {
+                        int p = __builtin_ctzll(faces);
+                        rows[p][j] |= (uint64_t)1 << i;
+                        faces &= faces - 1;
+                    }
+                }
+            }
+
+            for (int p = 0; p < lim[d]; p++) {
+                chunk->sliceOffsets[chunk_slice_index(chunk, b, d, p)] = chunk->mesh.quads.size;
+                chunk_merge_slice(chunk, &chunk->mesh, b, d, p, rows[p]);
+            }
+        }
+    }
+}
+
+void chunk_slice_rows(Chunk* chunk, Chunk** neighbors, int b, int d, int p, uint64_t* rows) {
+    int lim[3] = {
+        chunk->width,
+        chunk->height,
+        chunk->length
+    };
+
+    int u = (d+1) % 3;
+    int v = (d+2) % 3;
+
+    // The layer in front of a face: inside this chunk, or the neighbor's boundary layer
+    int q = b ? p+1 : p-1;
+    Chunk* neighbor = NULL;
+    int layer = 0;
+
+    if (q < 0 || q >= lim[d]) {
+        neighbor = chunk_neighbor(chunk, neighbors, b ? chunk_high_faces[d] : chunk_low_faces[d]);
+
+        if (neighbor && !b) {
+            int neighborLim[3] = { neighbor->width, neighbor->height, neighbor->length };
+            layer = neighborLim[d] - 1;
+        }
+    }
+
+    int x[3];
+
+    for (int j = 0; j < lim[u]; j++) {
+        rows[j] = 0;
+
+        for (int i = 0; i < lim[v]; i++) {
+            x[d] = p;
+            x[u] = j;
+            x[v] = i;
+
+            if (!block_is_active(&chunk->blocks[x[0]][x[1]][x[2]]))
+                continue;
+
+            char covered;
+            if (q >= 0 && q < lim[d]) {
+                x[d] = q;
+                covered = block_is_active(&chunk->blocks[x[0]][x[1]][x[2]]);
+            } else {
+                covered = chunk_neighbor_active(neighbor, d, layer, x);
+            }
+
+            if (!covered)
+                rows[j] |= (uint64_t)1 << i;
+        }
+    }
+}
+
+void chunk_merge_slice(Chunk* chunk, Mesh* mesh, int b, int d, int p, uint64_t* slice) {
+    int lim[3] = {
+        chunk->width,
+        chunk->height,
+        chunk->length
+    };
+
+    int u = (d+1) % 3;
+    int v = (d+2) % 3;
+
+    int x[3];
+
+    for (int j = 0; j < lim[u]; j++) {
+
+        while (slice[j]) {
+            int i = __builtin_ctzll(slice[j]);
+
+            x[d] = p;
+            x[u] = j;
+            x[v] = i;
+            uint16_t color = block_color(&chunk->blocks[x[0]][x[1]][x[2]]);
+
+            int w;
+            for (w = 1; i+w < lim[v] && (slice[j] >> (i+w) & 1); w++) {
+                x[v] = i+w;
+                if (block_color(&chunk->blocks[x[0]][x[1]][x[2]]) != color)
+                    break;
+            }
+
+            uint64_t run = (w == 64 ? ~(uint64_t)0 : (((uint64_t)1 << w) - 1)) << i;
+
+            int h;
+            for (h = 1; j+h < lim[u]; h++) {
+                if ((slice[j+h] & run) != run)
+                    break;
+
+                x[u] = j+h;
+
+                int k;
+                for (k = 0; k < w; k++) {
+                    x[v] = i+k;
+                    if (block_color(&chunk->blocks[x[0]][x[1]][x[2]]) != color)
+                        break;
+                }
+
+                if (k < w)
+                    break;
+            }
 
-                free(mask);
+            for (int l = 0; l < h; l++) {
+                slice[j+l] &= ~run;
             }
+
+            x[d] = b ? p+1 : p;
+            x[u] = j;
+            x[v] = i;
+
+            chunk_emit_quad(mesh, b, d, x, h, w, color);
         }
     }
+}
+
+/* Chunk */
+
+Chunk* chunk_init(Chunk* c, int width, int height, int length) {
+    Chunk* chunk = c ? c : NEW(Chunk, 1);
+
+    chunk->width = width;
+    chunk->height = height;
+    chunk->length = length;
+
+    chunk->dirty = 0;
+
+    for (int f = 0; f < 6; f++) {
+        chunk->connectivity[f] = (1 << 6) - 1;
+    }
+
+    mesh_init(&chunk->mesh);
+
+    chunk->sliceOffsets = NEW(int, chunk_slice_count(chunk) + 1);
+    chunk->staleSlices = NEW(char, chunk_slice_count(chunk));
+    memset(chunk->sliceOffsets, 0, (chunk_slice_count(chunk) + 1) * sizeof(int));
+    memset(chunk->staleSlices, 0, chunk_slice_count(chunk));
+    chunk->stale = 0;
+
+    chunk->blocks = NEW(Block**, width);
+
+    for (int x=0; x<width; x++) {
+        chunk->blocks[x] = NEW(Block*, height);
+
+        for (int y=0; y<height; y++) {
+            chunk->blocks[x][y] = NEW(Block, length);
+
+            for (int z=0; z<length; z++) {
+                chunk->blocks[x][y][z].data = 0;
+            }
+        }
+    }
+
+    return chunk;
+}
+
+void chunk_destroy(Chunk* chunk) {
+    for (int x=0; x<chunk->width; x++) {
+        for (int y=0; y<chunk->height; y++) {
+            free(chunk->blocks[x][y]);
+        }
+        free(chunk->blocks[x]);
+    }
+    free(chunk->blocks);
+
+    free(chunk->staleSlices);
+    free(chunk->sliceOffsets);
+
+    mesh_destroy(&chunk->mesh);
+}
+
+void chunk_mesh(Chunk* chunk, Chunk** neighbors) {
+    mesh_clear(&chunk->mesh);
+
+    if (chunk->width  <= CHUNK_BINARY_MESH_MAX &&
+        chunk->height <= CHUNK_BINARY_MESH_MAX &&
+        chunk->length <= CHUNK_BINARY_MESH_MAX) {
+        chunk_mesh_binary(chunk, neighbors);
+    } else {
+        chunk_mesh_masks(chunk, neighbors);
+    }
+
+    chunk->sliceOffsets[chunk_slice_count(chunk)] = chunk->mesh.quads.size;
+    memset(chunk->staleSlices, 0, chunk_slice_count(chunk));
+    chunk->stale = 0;
+
+    chunk->mesh.format = (chunk->width  <= MESH_PACKED_POSITION_MAX &&
+                          chunk->height <= MESH_PACKED_POSITION_MAX &&
+                          chunk->length <= MESH_PACKED_POSITION_MAX)
+                         ? MESH_FORMAT_PACKED
+                         : MESH_FORMAT_FLOAT;
+
+    mesh_calc_normals(&chunk->mesh);
+    mesh_buffer(&chunk->mesh, MESH_FILL);
+
+    chunk_calc_connectivity(chunk);
+}
+
+void chunk_remesh(Chunk* chunk, Chunk** neighbors) {
+    int count = chunk_slice_count(chunk);
+
+    if (!chunk->stale)
+        return;
+
+    // Past a quarter of the slices, or without the binary mesher, a full mesh is cheaper
+    if (chunk->stale * 4 > count ||
+        chunk->width  > CHUNK_BINARY_MESH_MAX ||
+        chunk->height > CHUNK_BINARY_MESH_MAX ||
+        chunk->length > CHUNK_BINARY_MESH_MAX) {
+        chunk_mesh(chunk, neighbors);
+        return;
+    }
+
+    static Mesh tail;
+    static char tail_initialized = 0;
+    if (!tail_initialized) {
+        mesh_init(&tail);
+        tail_initialized = 1;
+    }
+    mesh_clear(&tail);
+
+    uint64_t rows[CHUNK_BINARY_MESH_MAX];
+
+    int first = 0;
+    while (!chunk->staleSlices[first])
+        first++;
+
+    int firstQuad = chunk->sliceOffsets[first];
+
+    // Rebuild stale slices and carry the others over, from the first stale slice on
+    for (int b = 0; b < 2; b++) {
+        for (int d = 0; d < 3; d++) {
+            int lim[3] = {
+                chunk->width,
+                chunk->height,
+                chunk->length
+            };
+
+            for (int p = 0; p < lim[d]; p++) {
+                int index = chunk_slice_index(chunk, b, d, p);
+                if (index < first)
+                    continue;
+
+                int start = chunk->sliceOffsets[index];
+                int end = chunk->sliceOffsets[index + 1];
+
+                chunk->sliceOffsets[index] = firstQuad + tail.quads.size;
+
+                if (chunk->staleSlices[index]) {
+                    chunk_slice_rows(chunk, neighbors, b, d, p, rows);
+                    chunk_merge_slice(chunk, &tail, b, d, p, rows);
+                    chunk->staleSlices[index] = 0;
+                } else {
+                    mesh_add_quads(&tail, &chunk->mesh.quads.data[start], end - start);
+                }
+            }
+        }
+    }
+
+    chunk->mesh.quads.size = firstQuad;
+    mesh_add_quads(&chunk->mesh, tail.quads.data, tail.quads.size);
+
+    chunk->sliceOffsets[count] = chunk->mesh.quads.size;
+    chunk->stale = 0;
+
+    mesh_calc_normals(&chunk->mesh);
+    mesh_buffer_range(&chunk->mesh, firstQuad);
+
+    chunk_calc_connectivity(chunk);
+}
+
+int chunk_visible_ranges(Chunk* chunk, float* eye, MeshRange* ranges) {
+    int lim[3] = {
+        chunk->width,
+        chunk->height,
+        chunk->length
+    };
+
+    int count = 0;
+
+    // Faces of one direction are contiguous, one slice after another, so the slices
+    // in front of the eye (chunk coordinates) form a single range per direction
+    for (int b = 0; b < 2; b++) {
+        for (int d = 0; d < 3; d++) {
+            int first = 0;
+            int last = lim[d] - 1;
+
+            if (b) {
+                last = MIN(last, (int)ceilf(eye[d]) - 2);
+            } else {
+                first = MAX(first, (int)floorf(eye[d]) + 1);
+            }
+
+            if (first > last)
+                continue;
+
+            int start = chunk->sliceOffsets[chunk_slice_index(chunk, b, d, first)];
+            int end = chunk->sliceOffsets[chunk_slice_index(chunk, b, d, last) + 1];
+
+            if (start == end)
+                continue;
+
+            if (count && ranges[count-1].first + ranges[count-1].count == start) {
+                ranges[count-1].count += end - start;
+            } else {
+                ranges[count].first = start;
+                ranges[count].count = end - start;
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+void chunk_invalidate_block(Chunk* chunk, int* position) {
+    chunk_invalidate_blocks(chunk, position, position);
+}
+
+void chunk_invalidate_blocks(Chunk* chunk, int* low, int* high) {
+    // Blocks can change their own faces and the faces of the blocks on either side
+    for (int d = 0; d < 3; d++) {
+        for (int p = low[d]; p <= high[d] + 1; p++)
+            chunk_invalidate_slice(chunk, 0, d, p);
+        for (int p = low[d] - 1; p <= high[d]; p++)
+            chunk_invalidate_slice(chunk, 1, d, p);
+    }
+}
+
+void chunk_invalidate_face(Chunk* chunk, int face) {
+    int lim[3] = {
+        chunk->width,
+        chunk->height,
+        chunk->length
+    };
+
+    for (int d = 0; d < 3; d++) {
+        if (face == chunk_low_faces[d])
+            chunk_invalidate_slice(chunk, 0, d, 0);
+        if (face == chunk_high_faces[d])
+            chunk_invalidate_slice(chunk, 1, d, lim[d] - 1);
+    }
+}
+
+void chunk_calc_connectivity(Chunk* chunk) {
+    int w = chunk->width;
+    int h = chunk->height;
+    int l = chunk->length;
+    int size = w * h * l;
+
+    for (int f = 0; f < 6; f++) {
+        chunk->connectivity[f] = 0;
+    }
+
+    // Scratch grows to the largest chunk seen, like the mesher's mask
+    static char* visited = NULL;
+    static int* stack = NULL;
+    static int capacity = 0;
+
+    if (size > capacity) {
+        capacity = size;
+        visited = realloc(visited, capacity * sizeof(char));
+        stack = realloc(stack, capacity * sizeof(int));
+    }
+    memset(visited, 0, size);
+
+    // Flood fill each air region and record which faces of the chunk it touches
+    for (int i = 0; i < size; i++) {
+        if (visited[i])
+            continue;
+
+        visited[i] = 1;
+
+        if (block_is_active(&chunk->blocks[i / (h * l)][(i / l) % h][i % l]))
+            continue;
+
+        uint8_t faces = 0;
+        int top = 0;
+        stack[top++] = i;
+
+        while (top) {
+            int j = stack[--top];
+            int x = j / (h * l);
+            int y = (j / l) % h;
+            int z = j % l;
+
+            if (x == 0)     faces |= 1 << WEST;
+            if (x == w - 1) faces |= 1 << EAST;
+            if (y == 0)     faces |= 1 << BOTTOM;
+            if (y == h - 1) faces |= 1 << TOP;
+            if (z == 0)     faces |= 1 << NORTH;
+            if (z == l - 1) faces |= 1 << SOUTH;
+
+            int neighbors[6][4] = {
+                { x - 1, y, z, j - h * l },
+                { x + 1, y, z, j + h * l },
+                { x, y - 1, z, j - l },
+                { x, y + 1, z, j + l },
+                { x, y, z - 1, j - 1 },
+                { x, y, z + 1, j + 1 }
+            };
+
+            for (int n = 0; n < 6; n++) {
+                int* neighbor = neighbors[n];
+
+                if (neighbor[0] < 0 || neighbor[0] >= w ||
+                    neighbor[1] < 0 || neighbor[1] >= h ||
+                    neighbor[2] < 0 || neighbor[2] >= l)
+                    continue;
+
+                if (visited[neighbor[3]])
+                    continue;
+
+                visited[neighbor[3]] = 1;
+
+                if (!block_is_active(&chunk->blocks[neighbor[0]][neighbor[1]][neighbor[2]]))
+                    stack[top++] = neighbor[3];
+            }
+        }
+
+        for (int f = 0; f < 6; f++) {
+            if (faces & (1 << f))
+                chunk->connectivity[f] |= faces;
+        }
+    }
+}
 
-    linked_list_foreach(&chunk->meshes, prepare_mesh, NULL);
+char chunk_faces_connected(Chunk* chunk, int faceA, int faceB) {
+    return (chunk->connectivity[faceA] & (1 << faceB)) != 0;
 }
 
@@ -1,10 +1,16 @@
 #ifndef CHUNK_H
 #define CHUNK_H
 
+#include <string.h>
+#include <math.h>
+
 #include "block.h"
 #include "mesh.h"
 #include "linked_list.h"
 
+// Chunks up to this size along every axis are meshed with one machine word per block column
+#define CHUNK_BINARY_MESH_MAX   64
+
 typedef struct {
     int x;
     int y;
@@ -13,11 +19,16 @@ typedef struct {
 
 typedef struct {
     Block*** blocks;
-    LinkedList meshes;
+    Mesh mesh;
     int width;
     int height;
     int length;
     char dirty;
+    uint8_t connectivity[6];
+
+    int* sliceOffsets;
+    char* staleSlices;
+    int stale;
 } Chunk;
 
 /* Chunk */
@@ -25,6 +36,17 @@ typedef struct {
 Chunk* chunk_init(Chunk* c, int width, int height, int length);
 void chunk_destroy(Chunk* chunk);
 
-void chunk_mesh(Chunk* chunk);
+// neighbors holds the adjacent chunks indexed by face, or NULL where there is only air
+void chunk_mesh(Chunk* chunk, Chunk** neighbors);
+void chunk_remesh(Chunk* chunk, Chunk** neighbors);
+
+int chunk_visible_ranges(Chunk* chunk, float* eye, MeshRange* ranges);
+
+void chunk_invalidate_block(Chunk* chunk, int* position);
+void chunk_invalidate_blocks(Chunk* chunk, int* low, int* high);
+void chunk_invalidate_face(Chunk* chunk, int face);
+
+void chunk_calc_connectivity(Chunk* chunk);
+char chunk_faces_connected(Chunk* chunk, int faceA, int faceB);
 
 #endif // CHUNK_H
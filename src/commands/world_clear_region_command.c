@@ -7,11 +7,15 @@ WorldClearRegionCommand* world_clear_region_command_init(World* world, Box* regi
     command->command.undo = world_clear_region_command_undo;
     command->command.redo = world_clear_region_command_redo;
     command->command.id = world_clear_region_command_id;
+    command->command.merge = world_clear_region_command_merge;
+    command->command.size = world_clear_region_command_size;
+    command->command.spill = world_clear_region_command_spill;
+    command->command.restore = world_clear_region_command_restore;
     command->command.destroy = world_clear_region_command_destroy;
 
     command->world = world;
     command->region = *region;
-    command->chunk = NULL;
+    command->delta = NULL;
 
     return command;
 }
@@ -19,42 +23,68 @@ WorldClearRegionCommand* world_clear_region_command_init(World* world, Box* regi
 void world_clear_region_command_redo(Command* command) {
     WorldClearRegionCommand* worldClearRegionCommand = (WorldClearRegionCommand*)command->parent;
 
-    worldClearRegionCommand->chunk = world_copy_chunk(worldClearRegionCommand->world, &worldClearRegionCommand->region);
-
-    for (int x = 0; x < worldClearRegionCommand->region.width; x++) {
-        for (int y = 0; y < worldClearRegionCommand->region.height; y++) {
-            for (int z = 0; z < worldClearRegionCommand->region.length; z++) {
-                int location[3] = {
-                    worldClearRegionCommand->region.position[0] + x,
-                    worldClearRegionCommand->region.position[1] + y,
-                    worldClearRegionCommand->region.position[2] + z
-                };
-                world_block_set_active(worldClearRegionCommand->world, location, 0);
-            }
-        }
+    // Redoing replays the recorded changes instead of editing again
+    if (worldClearRegionCommand->delta) {
+        world_apply_delta(worldClearRegionCommand->world, worldClearRegionCommand->delta, 0);
+        return;
     }
+
+    worldClearRegionCommand->delta = world_delta_init(NULL, &worldClearRegionCommand->region);
+    world_fill_region(worldClearRegionCommand->world, &worldClearRegionCommand->region, 0, 0, worldClearRegionCommand->delta);
+    world_delta_trim(worldClearRegionCommand->delta);
 }
 
 void world_clear_region_command_undo(Command* command) {
     WorldClearRegionCommand* worldClearRegionCommand = (WorldClearRegionCommand*)command->parent;
-    int position[3] = {
-        worldClearRegionCommand->region.position[0],
-        worldClearRegionCommand->region.position[1],
-        worldClearRegionCommand->region.position[2]
-    };
 
-    world_set_chunk(worldClearRegionCommand->world, worldClearRegionCommand->chunk, position, 0);
+    world_apply_delta(worldClearRegionCommand->world, worldClearRegionCommand->delta, 1);
 }
 
 int world_clear_region_command_id() {
-    return 0;
+    return WORLD_CLEAR_REGION_COMMAND_ID;
+}
+
+bool world_clear_region_command_merge(Command* command, Command* other) {
+    WorldClearRegionCommand* worldClearRegionCommand = (WorldClearRegionCommand*)command->parent;
+    WorldClearRegionCommand* otherCommand = (WorldClearRegionCommand*)other->parent;
+
+    // Both edits have already run, so only their changes need combining
+    WorldDelta* delta = worldClearRegionCommand->delta;
+    world_delta_absorb(delta, otherCommand->delta);
+
+    worldClearRegionCommand->region.position[0] = delta->position[0];
+    worldClearRegionCommand->region.position[1] = delta->position[1];
+    worldClearRegionCommand->region.position[2] = delta->position[2];
+    worldClearRegionCommand->region.width = delta->size[0];
+    worldClearRegionCommand->region.height = delta->size[1];
+    worldClearRegionCommand->region.length = delta->size[2];
+
+    return true;
+}
+
+size_t world_clear_region_command_size(Command* command) {
+    WorldClearRegionCommand* worldClearRegionCommand = (WorldClearRegionCommand*)command->parent;
+
+    return sizeof(WorldClearRegionCommand) + (worldClearRegionCommand->delta ? world_delta_size(worldClearRegionCommand->delta) : 0);
+}
+
+bool world_clear_region_command_spill(Command* command, FILE* file) {
+    WorldClearRegionCommand* worldClearRegionCommand = (WorldClearRegionCommand*)command->parent;
+
+    return worldClearRegionCommand->delta && world_delta_spill(worldClearRegionCommand->delta, file);
+}
+
+bool world_clear_region_command_restore(Command* command, FILE* file) {
+    WorldClearRegionCommand* worldClearRegionCommand = (WorldClearRegionCommand*)command->parent;
+
+    return !worldClearRegionCommand->delta || world_delta_restore(worldClearRegionCommand->delta, file);
 }
 
 void world_clear_region_command_destroy(Command* command) {
     WorldClearRegionCommand* worldClearRegionCommand = (WorldClearRegionCommand*)command->parent;
 
-    if (worldClearRegionCommand->chunk) {
-        chunk_destroy(worldClearRegionCommand->chunk);
-        free(worldClearRegionCommand->chunk);
+    if (worldClearRegionCommand->delta) {
+        world_delta_destroy(worldClearRegionCommand->delta);
+        free(worldClearRegionCommand->delta);
     }
 }
\ No newline at end of file
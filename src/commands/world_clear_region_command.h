@@ -5,11 +5,13 @@
 #include "../box.h"
 #include "../world.h"
 
+#define WORLD_CLEAR_REGION_COMMAND_ID    2
+
 typedef struct {
     Command command;
     World* world;
     Box region;
-    Chunk* chunk;
+    WorldDelta* delta;
 } WorldClearRegionCommand;
 
 WorldClearRegionCommand* world_clear_region_command_init(World* world, Box* region);
@@ -17,6 +19,10 @@ WorldClearRegionCommand* world_clear_region_command_init(World* world, Box* regi
 void world_clear_region_command_undo(Command* command);
 void world_clear_region_command_redo(Command* command);
 int world_clear_region_command_id();
+bool world_clear_region_command_merge(Command* command, Command* other);
+size_t world_clear_region_command_size(Command* command);
+bool world_clear_region_command_spill(Command* command, FILE* file);
+bool world_clear_region_command_restore(Command* command, FILE* file);
 void world_clear_region_command_destroy(Command* command);
 
 #endif // WORLD_CLEAR_REGION_COMMAND_H
\ No newline at end of file
@@ -7,13 +7,17 @@ WorldCopyChunkCommand* world_copy_chunk_command_init(World* world, Chunk* chunk,
     command->command.undo = world_copy_chunk_command_undo;
     command->command.redo = world_copy_chunk_command_redo;
     command->command.id = world_copy_chunk_command_id;
+    command->command.merge = NULL;
+    command->command.size = world_copy_chunk_command_size;
+    command->command.spill = world_copy_chunk_command_spill;
+    command->command.restore = world_copy_chunk_command_restore;
     command->command.destroy = world_copy_chunk_command_destroy;
 
     command->world = world;
     command->chunk = chunk;
     memcpy(command->toLocation, location, sizeof(command->toLocation));
 
-    command->chunkBefore = NULL;
+    command->delta = NULL;
 
     command->rotation = rotation;
 
@@ -23,88 +27,56 @@ WorldCopyChunkCommand* world_copy_chunk_command_init(World* world, Chunk* chunk,
 void world_copy_chunk_command_redo(Command* command) {
     WorldCopyChunkCommand* worldCopyChunkCommand = (WorldCopyChunkCommand*)command->parent;
 
-    Box regionBefore;
-    box_init(&regionBefore);
-
-    regionBefore.width = worldCopyChunkCommand->chunk->width;
-    regionBefore.height = worldCopyChunkCommand->chunk->height;
-    regionBefore.length = worldCopyChunkCommand->chunk->length;
-
-    regionBefore.position[0] = worldCopyChunkCommand->toLocation[0];
-    regionBefore.position[1] = worldCopyChunkCommand->toLocation[1];
-    regionBefore.position[2] = worldCopyChunkCommand->toLocation[2];
-
-    if (worldCopyChunkCommand->rotation % 2 == 1) {
-        float temp = regionBefore.width;
-        regionBefore.width = regionBefore.length;
-        regionBefore.length = temp;
+    // Redoing replays the recorded changes instead of editing again
+    if (worldCopyChunkCommand->delta) {
+        world_apply_delta(worldCopyChunkCommand->world, worldCopyChunkCommand->delta, 0);
+        return;
     }
 
-    switch (worldCopyChunkCommand->rotation) {
-        case 0:
-            break;
-        case 1:
-            regionBefore.position[2] -= regionBefore.length - 1;
-            break;
-        case 2:
-            regionBefore.position[0] -= regionBefore.width - 1;
-            regionBefore.position[2] -= regionBefore.length - 1;
-            break;
-        case 3:
-            regionBefore.position[0] -= regionBefore.width - 1;
-            break;
-        default:
-            break;
-    }
+    Box region;
+    world_chunk_region(&region, worldCopyChunkCommand->chunk, worldCopyChunkCommand->toLocation, worldCopyChunkCommand->rotation);
 
-    worldCopyChunkCommand->chunkBefore = world_copy_chunk(worldCopyChunkCommand->world, &regionBefore);
+    worldCopyChunkCommand->delta = world_delta_init(NULL, &region);
+    world_set_chunk(worldCopyChunkCommand->world, worldCopyChunkCommand->chunk, worldCopyChunkCommand->toLocation, worldCopyChunkCommand->rotation, worldCopyChunkCommand->delta);
+    world_delta_trim(worldCopyChunkCommand->delta);
 
-    world_set_chunk(worldCopyChunkCommand->world, worldCopyChunkCommand->chunk, worldCopyChunkCommand->toLocation, worldCopyChunkCommand->rotation);
+    // The chunk belongs to the picker, which may free it after this edit
+    worldCopyChunkCommand->chunk = NULL;
 }
 
 void world_copy_chunk_command_undo(Command* command) {
     WorldCopyChunkCommand* worldCopyChunkCommand = (WorldCopyChunkCommand*)command->parent;
 
-    int location[] = {
-        worldCopyChunkCommand->toLocation[0],
-        worldCopyChunkCommand->toLocation[1],
-        worldCopyChunkCommand->toLocation[2]
-    };
-
-    switch (worldCopyChunkCommand->rotation) {
-        case 0:
-            break;
-        case 1:
-            location[2] -= worldCopyChunkCommand->chunkBefore->length - 1;
-            break;
-        case 2:
-            location[0] -= worldCopyChunkCommand->chunkBefore->width - 1;
-            location[2] -= worldCopyChunkCommand->chunkBefore->length - 1;
-            break;
-        case 3:
-            location[0] -= worldCopyChunkCommand->chunkBefore->width - 1;
-            break;
-        default:
-            break;
-    }
-
-    world_set_chunk(worldCopyChunkCommand->world, worldCopyChunkCommand->chunkBefore, location, 0);
+    world_apply_delta(worldCopyChunkCommand->world, worldCopyChunkCommand->delta, 1);
 }
 
 int world_copy_chunk_command_id() {
     return 0;
 }
 
-void world_copy_chunk_command_destroy(Command* command) {
+size_t world_copy_chunk_command_size(Command* command) {
     WorldCopyChunkCommand* worldCopyChunkCommand = (WorldCopyChunkCommand*)command->parent;
 
-    if (worldCopyChunkCommand->chunkBefore) {
-        chunk_destroy(worldCopyChunkCommand->chunkBefore);
-        free(worldCopyChunkCommand->chunkBefore);
-    }
+    return sizeof(WorldCopyChunkCommand) + (worldCopyChunkCommand->delta ? world_delta_size(worldCopyChunkCommand->delta) : 0);
+}
+
+bool world_copy_chunk_command_spill(Command* command, FILE* file) {
+    WorldCopyChunkCommand* worldCopyChunkCommand = (WorldCopyChunkCommand*)command->parent;
+
+    return worldCopyChunkCommand->delta && world_delta_spill(worldCopyChunkCommand->delta, file);
+}
+
+bool world_copy_chunk_command_restore(Command* command, FILE* file) {
+    WorldCopyChunkCommand* worldCopyChunkCommand = (WorldCopyChunkCommand*)command->parent;
+
+    return !worldCopyChunkCommand->delta || world_delta_restore(worldCopyChunkCommand->delta, file);
+}
+
+void world_copy_chunk_command_destroy(Command* command) {
+    WorldCopyChunkCommand* worldCopyChunkCommand = (WorldCopyChunkCommand*)command->parent;
 
-    if (worldCopyChunkCommand->chunk) {
-        chunk_destroy(worldCopyChunkCommand->chunk);
-        free(worldCopyChunkCommand->chunk);
+    if (worldCopyChunkCommand->delta) {
+        world_delta_destroy(worldCopyChunkCommand->delta);
+        free(worldCopyChunkCommand->delta);
     }
 }
\ No newline at end of file
@@ -8,8 +8,9 @@
 typedef struct {
     Command command;
     World* world;
+    // Borrowed until the first redo has recorded the delta
     Chunk* chunk;
-    Chunk* chunkBefore;
+    WorldDelta* delta;
     int toLocation[3];
     int rotation;
 } WorldCopyChunkCommand;
@@ -19,6 +20,9 @@ WorldCopyChunkCommand* world_copy_chunk_command_init(World* world, Chunk* chunk,
 void world_copy_chunk_command_undo(Command* command);
 void world_copy_chunk_command_redo(Command* command);
 int world_copy_chunk_command_id();
+size_t world_copy_chunk_command_size(Command* command);
+bool world_copy_chunk_command_spill(Command* command, FILE* file);
+bool world_copy_chunk_command_restore(Command* command, FILE* file);
 void world_copy_chunk_command_destroy(Command* command);
 
 #endif // WORLD_COPY_CHUNK_COMMAND
\ No newline at end of file
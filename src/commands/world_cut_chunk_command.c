@@ -7,6 +7,10 @@ WorldCutChunkCommand* world_cut_chunk_command_init(World* world, Chunk* chunk, i
     command->command.undo = world_cut_chunk_command_undo;
     command->command.redo = world_cut_chunk_command_redo;
     command->command.id = world_cut_chunk_command_id;
+    command->command.merge = NULL;
+    command->command.size = world_cut_chunk_command_size;
+    command->command.spill = world_cut_chunk_command_spill;
+    command->command.restore = world_cut_chunk_command_restore;
     command->command.destroy = world_cut_chunk_command_destroy;
 
     command->world = world;
@@ -14,7 +18,8 @@ WorldCutChunkCommand* world_cut_chunk_command_init(World* world, Chunk* chunk, i
     memcpy(command->fromLocation, fromLocation, sizeof(command->fromLocation));
     memcpy(command->toLocation, toLocation, sizeof(command->toLocation));
 
-    command->chunkBefore = NULL;
+    command->sourceDelta = NULL;
+    command->delta = NULL;
 
     command->rotation = rotation;
 
@@ -24,102 +29,116 @@ WorldCutChunkCommand* world_cut_chunk_command_init(World* world, Chunk* chunk, i
 void world_cut_chunk_command_redo(Command* command) {
     WorldCutChunkCommand* worldCutChunkCommand = (WorldCutChunkCommand*)command->parent;
 
-    Box regionBefore;
-    box_init(&regionBefore);
+    // Redoing replays the recorded changes instead of editing again
+    if (worldCutChunkCommand->delta) {
+        world_apply_delta(worldCutChunkCommand->world, worldCutChunkCommand->sourceDelta, 0);
+        world_apply_delta(worldCutChunkCommand->world, worldCutChunkCommand->delta, 0);
+        return;
+    }
 
-    regionBefore.width = worldCutChunkCommand->chunk->width;
-    regionBefore.height = worldCutChunkCommand->chunk->height;
-    regionBefore.length = worldCutChunkCommand->chunk->length;
+    Box regionSource;
+    world_chunk_region(&regionSource, worldCutChunkCommand->chunk, worldCutChunkCommand->fromLocation, 0);
 
-    regionBefore.position[0] = worldCutChunkCommand->toLocation[0];
-    regionBefore.position[1] = worldCutChunkCommand->toLocation[1];
-    regionBefore.position[2] = worldCutChunkCommand->toLocation[2];
+    world_cut_chunk_command_record_source(worldCutChunkCommand, &regionSource);
+    world_apply_delta(worldCutChunkCommand->world, worldCutChunkCommand->sourceDelta, 0);
 
-    if (worldCutChunkCommand->rotation % 2 == 1) {
-        float temp = regionBefore.width;
-        regionBefore.width = regionBefore.length;
-        regionBefore.length = temp;
-    }
+    Box region;
+    world_chunk_region(&region, worldCutChunkCommand->chunk, worldCutChunkCommand->toLocation, worldCutChunkCommand->rotation);
 
-    switch (worldCutChunkCommand->rotation) {
-        case 0:
-            break;
-        case 1:
-            regionBefore.position[2] -= regionBefore.length - 1;
-            break;
-        case 2:
-            regionBefore.position[0] -= regionBefore.width - 1;
-            regionBefore.position[2] -= regionBefore.length - 1;
-            break;
-        case 3:
-            regionBefore.position[0] -= regionBefore.width - 1;
-            break;
-        default:
-            break;
-    }
+    worldCutChunkCommand->delta = world_delta_init(NULL, &region);
+    world_set_chunk(worldCutChunkCommand->world, worldCutChunkCommand->chunk, worldCutChunkCommand->toLocation, worldCutChunkCommand->rotation, worldCutChunkCommand->delta);
+    world_delta_trim(worldCutChunkCommand->delta);
 
-    Box regionSource;
-    box_init(&regionSource);
+    // The chunk belongs to the picker, which may free it after this edit
+    worldCutChunkCommand->chunk = NULL;
+}
+
+void world_cut_chunk_command_undo(Command* command) {
+    WorldCutChunkCommand* worldCutChunkCommand = (WorldCutChunkCommand*)command->parent;
+
+    world_apply_delta(worldCutChunkCommand->world, worldCutChunkCommand->delta, 1);
+    world_apply_delta(worldCutChunkCommand->world, worldCutChunkCommand->sourceDelta, 1);
+}
 
-    regionSource.width = worldCutChunkCommand->chunk->width;
-    regionSource.height = worldCutChunkCommand->chunk->height;
-    regionSource.length = worldCutChunkCommand->chunk->length;
+int world_cut_chunk_command_id() {
+    return 0;
+}
 
-    regionSource.position[0] = worldCutChunkCommand->fromLocation[0];
-    regionSource.position[1] = worldCutChunkCommand->fromLocation[1];
-    regionSource.position[2] = worldCutChunkCommand->fromLocation[2];
+size_t world_cut_chunk_command_size(Command* command) {
+    WorldCutChunkCommand* worldCutChunkCommand = (WorldCutChunkCommand*)command->parent;
 
+    size_t bytes = sizeof(WorldCutChunkCommand);
 
-    worldCutChunkCommand->chunkBefore = world_copy_chunk(worldCutChunkCommand->world, &regionBefore);
+    if (worldCutChunkCommand->sourceDelta)
+        bytes += world_delta_size(worldCutChunkCommand->sourceDelta);
+    if (worldCutChunkCommand->delta)
+        bytes += world_delta_size(worldCutChunkCommand->delta);
 
-    world_clear_region(worldCutChunkCommand->world, &regionSource);
-    world_set_chunk(worldCutChunkCommand->world, worldCutChunkCommand->chunk, worldCutChunkCommand->toLocation, worldCutChunkCommand->rotation);
+    return bytes;
 }
 
-void world_cut_chunk_command_undo(Command* command) {
+bool world_cut_chunk_command_spill(Command* command, FILE* file) {
     WorldCutChunkCommand* worldCutChunkCommand = (WorldCutChunkCommand*)command->parent;
 
-    int location[] = {
-        worldCutChunkCommand->toLocation[0],
-        worldCutChunkCommand->toLocation[1],
-        worldCutChunkCommand->toLocation[2]
-    };
-
-    switch (worldCutChunkCommand->rotation) {
-        case 0:
-            break;
-        case 1:
-            location[2] -= worldCutChunkCommand->chunkBefore->length - 1;
-            break;
-        case 2:
-            location[0] -= worldCutChunkCommand->chunkBefore->width - 1;
-            location[2] -= worldCutChunkCommand->chunkBefore->length - 1;
-            break;
-        case 3:
-            location[0] -= worldCutChunkCommand->chunkBefore->width - 1;
-            break;
-        default:
-            break;
-    }
+    if (!worldCutChunkCommand->delta)
+        return false;
+
+    // Restore reads the deltas back in this order, so the second is only
+    // written once the first is safely out
+    bool spilled = world_delta_spill(worldCutChunkCommand->sourceDelta, file);
+    if (!spilled && worldCutChunkCommand->sourceDelta->spanCount > 0)
+        return false;
 
-    world_set_chunk(worldCutChunkCommand->world, worldCutChunkCommand->chunkBefore, location, 0);
-    world_set_chunk(worldCutChunkCommand->world, worldCutChunkCommand->chunk, worldCutChunkCommand->fromLocation, 0);
+    return world_delta_spill(worldCutChunkCommand->delta, file) || spilled;
 }
 
-int world_cut_chunk_command_id() {
-    return 0;
+bool world_cut_chunk_command_restore(Command* command, FILE* file) {
+    WorldCutChunkCommand* worldCutChunkCommand = (WorldCutChunkCommand*)command->parent;
+
+    if (!worldCutChunkCommand->delta)
+        return true;
+
+    return world_delta_restore(worldCutChunkCommand->sourceDelta, file) &&
+           world_delta_restore(worldCutChunkCommand->delta, file);
 }
 
 void world_cut_chunk_command_destroy(Command* command) {
     WorldCutChunkCommand* worldCutChunkCommand = (WorldCutChunkCommand*)command->parent;
 
-    if (worldCutChunkCommand->chunkBefore) {
-        chunk_destroy(worldCutChunkCommand->chunkBefore);
-        free(worldCutChunkCommand->chunkBefore);
+    if (worldCutChunkCommand->sourceDelta) {
+        world_delta_destroy(worldCutChunkCommand->sourceDelta);
+        free(worldCutChunkCommand->sourceDelta);
     }
 
-    if (worldCutChunkCommand->chunk) {
-        chunk_destroy(worldCutChunkCommand->chunk);
-        free(worldCutChunkCommand->chunk);
+    if (worldCutChunkCommand->delta) {
+        world_delta_destroy(worldCutChunkCommand->delta);
+        free(worldCutChunkCommand->delta);
     }
-}
\ No newline at end of file
+}
+
+void world_cut_chunk_command_record_source(WorldCutChunkCommand* command, Box* regionSource) {
+    Chunk* chunk = command->chunk;
+
+    // The picker has usually cleared the source already, so its blocks are
+    // read from the cut chunk rather than the world
+    command->sourceDelta = world_delta_init(NULL, regionSource);
+
+    for (int x = 0; x < chunk->width; x++) {
+        for (int y = 0; y < chunk->height; y++) {
+            for (int z = 0; z < chunk->length; z++) {
+                uint16_t before = chunk->blocks[x][y][z].data;
+
+                if (before) {
+                    int location[3] = {
+                        command->fromLocation[0] + x,
+                        command->fromLocation[1] + y,
+                        command->fromLocation[2] + z
+                    };
+                    world_delta_record(command->sourceDelta, world_delta_index(command->sourceDelta, location), before, 0);
+                }
+            }
+        }
+    }
+
+    world_delta_trim(command->sourceDelta);
+}
@@ -8,8 +8,10 @@
 typedef struct {
     Command command;
     World* world;
+    // Borrowed until the first redo has recorded both deltas
     Chunk* chunk;
-    Chunk* chunkBefore;
+    WorldDelta* sourceDelta;
+    WorldDelta* delta;
     int fromLocation[3];
     int toLocation[3];
     int rotation;
@@ -20,6 +22,11 @@ WorldCutChunkCommand* world_cut_chunk_command_init(World* world, Chunk* chunk, i
 void world_cut_chunk_command_undo(Command* command);
 void world_cut_chunk_command_redo(Command* command);
 int world_cut_chunk_command_id();
+size_t world_cut_chunk_command_size(Command* command);
+bool world_cut_chunk_command_spill(Command* command, FILE* file);
+bool world_cut_chunk_command_restore(Command* command, FILE* file);
 void world_cut_chunk_command_destroy(Command* command);
 
+void world_cut_chunk_command_record_source(WorldCutChunkCommand* command, Box* regionSource);
+
 #endif // WORLD_CUT_CHUNK_COMMAND
\ No newline at end of file
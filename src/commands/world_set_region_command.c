@@ -7,12 +7,16 @@ WorldSetRegionCommand* world_set_region_command_init(World* world, Box* region,
     command->command.undo = world_set_region_command_undo;
     command->command.redo = world_set_region_command_redo;
     command->command.id = world_set_region_command_id;
+    command->command.merge = world_set_region_command_merge;
+    command->command.size = world_set_region_command_size;
+    command->command.spill = world_set_region_command_spill;
+    command->command.restore = world_set_region_command_restore;
     command->command.destroy = world_set_region_command_destroy;
 
     command->world = world;
     command->region = *region;
     command->color = color;
-    command->chunk = NULL;
+    command->delta = NULL;
 
     return command;
 }
@@ -20,43 +24,68 @@ WorldSetRegionCommand* world_set_region_command_init(World* world, Box* region,
 void world_set_region_command_redo(Command* command) {
     WorldSetRegionCommand* worldSetRegionCommand = (WorldSetRegionCommand*)command->parent;
 
-    worldSetRegionCommand->chunk = world_copy_chunk(worldSetRegionCommand->world, &worldSetRegionCommand->region);
-
-    for (int x = 0; x < worldSetRegionCommand->region.width; x++) {
-        for (int y = 0; y < worldSetRegionCommand->region.height; y++) {
-            for (int z = 0; z < worldSetRegionCommand->region.length; z++) {
-                int location[3] = {
-                    worldSetRegionCommand->region.position[0] + x,
-                    worldSetRegionCommand->region.position[1] + y,
-                    worldSetRegionCommand->region.position[2] + z
-                };
-                world_block_set_color(worldSetRegionCommand->world, location, worldSetRegionCommand->color);
-                world_block_set_active(worldSetRegionCommand->world, location, 1);
-            }
-        }
+    // Redoing replays the recorded changes instead of editing again
+    if (worldSetRegionCommand->delta) {
+        world_apply_delta(worldSetRegionCommand->world, worldSetRegionCommand->delta, 0);
+        return;
     }
+
+    worldSetRegionCommand->delta = world_delta_init(NULL, &worldSetRegionCommand->region);
+    world_fill_region(worldSetRegionCommand->world, &worldSetRegionCommand->region, 1, worldSetRegionCommand->color, worldSetRegionCommand->delta);
+    world_delta_trim(worldSetRegionCommand->delta);
 }
 
 void world_set_region_command_undo(Command* command) {
     WorldSetRegionCommand* worldSetRegionCommand = (WorldSetRegionCommand*)command->parent;
-    int position[3] = {
-        worldSetRegionCommand->region.position[0],
-        worldSetRegionCommand->region.position[1],
-        worldSetRegionCommand->region.position[2]
-    };
 
-    world_set_chunk(worldSetRegionCommand->world, worldSetRegionCommand->chunk, position, 0);
+    world_apply_delta(worldSetRegionCommand->world, worldSetRegionCommand->delta, 1);
 }
 
 int world_set_region_command_id() {
-    return 0;
+    return WORLD_SET_REGION_COMMAND_ID;
+}
+
+bool world_set_region_command_merge(Command* command, Command* other) {
+    WorldSetRegionCommand* worldSetRegionCommand = (WorldSetRegionCommand*)command->parent;
+    WorldSetRegionCommand* otherCommand = (WorldSetRegionCommand*)other->parent;
+
+    // Both edits have already run, so only their changes need combining
+    WorldDelta* delta = worldSetRegionCommand->delta;
+    world_delta_absorb(delta, otherCommand->delta);
+
+    worldSetRegionCommand->region.position[0] = delta->position[0];
+    worldSetRegionCommand->region.position[1] = delta->position[1];
+    worldSetRegionCommand->region.position[2] = delta->position[2];
+    worldSetRegionCommand->region.width = delta->size[0];
+    worldSetRegionCommand->region.height = delta->size[1];
+    worldSetRegionCommand->region.length = delta->size[2];
+
+    return true;
+}
+
+size_t world_set_region_command_size(Command* command) {
+    WorldSetRegionCommand* worldSetRegionCommand = (WorldSetRegionCommand*)command->parent;
+
+    return sizeof(WorldSetRegionCommand) + (worldSetRegionCommand->delta ? world_delta_size(worldSetRegionCommand->delta) : 0);
+}
+
+bool world_set_region_command_spill(Command* command, FILE* file) {
+    WorldSetRegionCommand* worldSetRegionCommand = (WorldSetRegionCommand*)command->parent;
+
+    return worldSetRegionCommand->delta && world_delta_spill(worldSetRegionCommand->delta, file);
+}
+
+bool world_set_region_command_restore(Command* command, FILE* file) {
+    WorldSetRegionCommand* worldSetRegionCommand = (WorldSetRegionCommand*)command->parent;
+
+    return !worldSetRegionCommand->delta || world_delta_restore(worldSetRegionCommand->delta, file);
 }
 
 void world_set_region_command_destroy(Command* command) {
     WorldSetRegionCommand* worldSetRegionCommand = (WorldSetRegionCommand*)command->parent;
 
-    if (worldSetRegionCommand->chunk) {
-        chunk_destroy(worldSetRegionCommand->chunk);
-        free(worldSetRegionCommand->chunk);
+    if (worldSetRegionCommand->delta) {
+        world_delta_destroy(worldSetRegionCommand->delta);
+        free(worldSetRegionCommand->delta);
     }
 }
\ No newline at end of file
@@ -5,12 +5,14 @@
 #include "../box.h"
 #include "../world.h"
 
+#define WORLD_SET_REGION_COMMAND_ID    1
+
 typedef struct {
     Command command;
     World* world;
     Box region;
     uint16_t color;
-    Chunk* chunk;
+    WorldDelta* delta;
 } WorldSetRegionCommand;
 
 WorldSetRegionCommand* world_set_region_command_init(World* world, Box* region, uint16_t color);
@@ -18,6 +20,10 @@ WorldSetRegionCommand* world_set_region_command_init(World* world, Box* region,
 void world_set_region_command_undo(Command* command);
 void world_set_region_command_redo(Command* command);
 int world_set_region_command_id();
+bool world_set_region_command_merge(Command* command, Command* other);
+size_t world_set_region_command_size(Command* command);
+bool world_set_region_command_spill(Command* command, FILE* file);
+bool world_set_region_command_restore(Command* command, FILE* file);
 void world_set_region_command_destroy(Command* command);
 
 #endif // WORLD_SET_REGION_COMMAND
\ No newline at end of file
@@ -4,7 +4,16 @@
 FPSPanel* fps_panel_init(FPSPanel* p, PanelManager* panelManager) {
     FPSPanel* fpsPanel = p ? p : NEW(FPSPanel, 1);
 
-    panel_init(&fpsPanel->panel, fpsPanel, fps_panel_draw, panelManager, FPS_PANEL_WIDTH, FPS_PANEL_HEIGHT);
+    // The text is drawn from the renderer's glyph atlas, so the panel has no texture
+    panel_init(&fpsPanel->panel, fpsPanel, NULL, panelManager, FPS_PANEL_WIDTH, FPS_PANEL_HEIGHT);
+
+    fpsPanel->fps = 0;
+    memset(&fpsPanel->stats, 0, sizeof(RendererStats));
+    fpsPanel->occlusionCulling = 0;
+    memset(&fpsPanel->arenaStats, 0, sizeof(GPUArenaStats));
+    memset(&fpsPanel->undoStats, 0, sizeof(UndoStackStats));
+
+    fps_panel_format(fpsPanel);
 
     return fpsPanel;
 }
@@ -15,26 +24,63 @@ void fps_panel_destroy(FPSPanel* fpsPanel) {
 
 void fps_panel_set_fps(FPSPanel* fpsPanel, float fps) {
     fpsPanel->fps = fps;
+    fps_panel_format(fpsPanel);
+}
+
+void fps_panel_set_stats(FPSPanel* fpsPanel, RendererStats* stats, char occlusionCulling) {
+    fpsPanel->stats = *stats;
+    fpsPanel->occlusionCulling = occlusionCulling;
+    fps_panel_format(fpsPanel);
 }
 
-void fps_panel_draw(void* fpsPanelPtr) {
-    FPSPanel* fpsPanel = (FPSPanel*)fpsPanelPtr;
+void fps_panel_set_arena_stats(FPSPanel* fpsPanel, GPUArenaStats* arenaStats) {
+    fpsPanel->arenaStats = *arenaStats;
+    fps_panel_format(fpsPanel);
+}
+
+void fps_panel_set_undo_stats(FPSPanel* fpsPanel, UndoStackStats* undoStats) {
+    fpsPanel->undoStats = *undoStats;
+    fps_panel_format(fpsPanel);
+}
 
-    char fpsStr[25];
-    sprintf(fpsStr, "%.2f FPS", fpsPanel->fps);
+void fps_panel_format(FPSPanel* fpsPanel) {
+    char (*lines)[FPS_PANEL_LINE_LENGTH] = fpsPanel->lines;
 
-    cairo_set_source_rgba(fpsPanel->panel.cr, 0, 0, 0, 0);
-    cairo_set_operator(fpsPanel->panel.cr, CAIRO_OPERATOR_SOURCE);
-    cairo_paint(fpsPanel->panel.cr);
-    cairo_set_operator(fpsPanel->panel.cr, CAIRO_OPERATOR_OVER);
+    snprintf(lines[0], FPS_PANEL_LINE_LENGTH, "%.2f FPS, %d draw calls", fpsPanel->fps, fpsPanel->stats.drawCalls);
 
-    cairo_set_source_rgb(fpsPanel->panel.cr, 0, 0, 0);
+    snprintf(lines[1], FPS_PANEL_LINE_LENGTH, "%d / %d chunks", fpsPanel->stats.chunksDrawn, fpsPanel->stats.chunksConsidered);
 
-    cairo_select_font_face(fpsPanel->panel.cr, "Cantarell Regular", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
-    cairo_set_font_size(fpsPanel->panel.cr, 12);
+    snprintf(lines[2], FPS_PANEL_LINE_LENGTH, "%d occluded (culling %s)",
+             fpsPanel->stats.chunksInFrustum - fpsPanel->stats.chunksDrawn,
+             fpsPanel->occlusionCulling ? "on" : "off");
+
+    snprintf(lines[3], FPS_PANEL_LINE_LENGTH, "%d quads, %d facing away",
+             fpsPanel->stats.quadsDrawn,
+             fpsPanel->stats.quadsFacingAway);
+
+    snprintf(lines[4], FPS_PANEL_LINE_LENGTH, "%d pages, %.0f%% used, %.0f%% fragmented",
+             fpsPanel->arenaStats.pages,
+             fpsPanel->arenaStats.occupancy * 100,
+             fpsPanel->arenaStats.fragmentation * 100);
+
+    snprintf(lines[5], FPS_PANEL_LINE_LENGTH, "%d GL state changes", fpsPanel->stats.stateChanges);
+
+    snprintf(lines[6], FPS_PANEL_LINE_LENGTH, "%d undo steps (%d on disk)",
+             fpsPanel->undoStats.commands,
+             fpsPanel->undoStats.spilled);
+
+    snprintf(lines[7], FPS_PANEL_LINE_LENGTH, "%.0f KB of undo, last %.0f KB",
+             fpsPanel->undoStats.bytes / 1024.0,
+             fpsPanel->undoStats.topBytes / 1024.0);
+}
 
-    cairo_move_to(fpsPanel->panel.cr, 0, 15);
-    cairo_show_text(fpsPanel->panel.cr, fpsStr);
+void fps_panel_queue_text(FPSPanel* fpsPanel, Renderer* renderer) {
+    for (int l = 0; l < FPS_PANEL_LINES; l++) {
+        renderer_queue_text(renderer,
+                            fpsPanel->panel.position[0],
+                            fpsPanel->panel.position[1] + 15 + l * 16,
+                            fpsPanel->lines[l]);
+    }
 }
 
 void fps_panel_set_position(FPSPanel* fpsPanel, unsigned int x, unsigned int y) {
@@ -4,16 +4,31 @@
 #include <stdio.h>
 
 #include "panel.h"
+#include "renderer.h"
+#include "undo_stack.h"
+
+#define FPS_PANEL_LINES         8
+#define FPS_PANEL_LINE_LENGTH   40
 
 typedef struct {
     Panel panel;
     float fps;
+    RendererStats stats;
+    char occlusionCulling;
+    GPUArenaStats arenaStats;
+    UndoStackStats undoStats;
+
+    char lines[FPS_PANEL_LINES][FPS_PANEL_LINE_LENGTH];
 } FPSPanel;
 
 FPSPanel* fps_panel_init(FPSPanel* p, PanelManager* panelManager);
 void fps_panel_destroy(FPSPanel* fpsPanel);
 
 void fps_panel_set_fps(FPSPanel* fpsPanel, float fps);
+void fps_panel_set_stats(FPSPanel* fpsPanel, RendererStats* stats, char occlusionCulling);
+void fps_panel_set_arena_stats(FPSPanel* fpsPanel, GPUArenaStats* arenaStats);
+void fps_panel_set_undo_stats(FPSPanel* fpsPanel, UndoStackStats* undoStats);
 void fps_panel_set_position(FPSPanel* fpsPanel, unsigned int x, unsigned int y);
+void fps_panel_queue_text(FPSPanel* fpsPanel, Renderer* renderer);
 
 #endif // FPS_PANEL_H
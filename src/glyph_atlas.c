@@ -0,0 +1,74 @@
+#include "glyph_atlas.h"
+
+GlyphAtlas* glyph_atlas_init(GlyphAtlas* a, const char* fontFace, double fontSize) {
+    GlyphAtlas* atlas = a ? a : NEW(GlyphAtlas, 1);
+
+    // Measure the font first so every glyph fits its cell with a pixel to spare
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
+    cairo_t* cr = cairo_create(surface);
+    cairo_select_font_face(cr, fontFace, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cr, fontSize);
+
+    cairo_font_extents_t fontExtents;
+    cairo_font_extents(cr, &fontExtents);
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+
+    atlas->ascent = ceil(fontExtents.ascent);
+    atlas->cellWidth = ceil(MAX(fontExtents.max_x_advance, fontSize)) + 2;
+    atlas->cellHeight = ceil(fontExtents.ascent + fontExtents.descent) + 2;
+    atlas->width = GLYPH_ATLAS_COLUMNS * atlas->cellWidth;
+    atlas->height = ((GLYPH_ATLAS_GLYPHS + GLYPH_ATLAS_COLUMNS - 1) / GLYPH_ATLAS_COLUMNS) * atlas->cellHeight;
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, atlas->width, atlas->height);
+    cr = cairo_create(surface);
+    cairo_select_font_face(cr, fontFace, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cr, fontSize);
+    cairo_set_source_rgb(cr, 0, 0, 0);
+
+    char str[2] = { 0, 0 };
+    for (int g = 0; g < GLYPH_ATLAS_GLYPHS; g++) {
+        int x = (g % GLYPH_ATLAS_COLUMNS) * atlas->cellWidth;
+        int y = (g / GLYPH_ATLAS_COLUMNS) * atlas->cellHeight;
+
+        str[0] = GLYPH_ATLAS_FIRST + g;
+
+        cairo_move_to(cr, x + 1, y + 1 + atlas->ascent);
+        cairo_show_text(cr, str);
+
+        cairo_text_extents_t textExtents;
+        cairo_text_extents(cr, str, &textExtents);
+
+        Glyph* glyph = &atlas->glyphs[g];
+        glyph->advance = textExtents.x_advance;
+        glyph->texcoord[0] = (float)x / atlas->width;
+        glyph->texcoord[1] = (float)y / atlas->height;
+        glyph->texcoord[2] = (float)(x + atlas->cellWidth) / atlas->width;
+        glyph->texcoord[3] = (float)(y + atlas->cellHeight) / atlas->height;
+    }
+
+    cairo_surface_flush(surface);
+
+    glGenTextures(1, &atlas->tex);
+    glBindTexture(GL_TEXTURE_2D, atlas->tex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, atlas->width, atlas->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, cairo_image_surface_get_data(surface));
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+
+    return atlas;
+}
+
+void glyph_atlas_destroy(GlyphAtlas* atlas) {
+    glDeleteTextures(1, &atlas->tex);
+}
+
+Glyph* glyph_atlas_glyph(GlyphAtlas* atlas, char c) {
+    if (c < GLYPH_ATLAS_FIRST || c > GLYPH_ATLAS_LAST)
+        c = '?';
+
+    return &atlas->glyphs[c - GLYPH_ATLAS_FIRST];
+}
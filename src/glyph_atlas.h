@@ -0,0 +1,39 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <math.h>
+
+#include <cairo/cairo.h>
+#include <GLES3/gl3.h>
+
+#include "global.h"
+
+// Printable ASCII, laid out in fixed-size cells
+#define GLYPH_ATLAS_FIRST       32
+#define GLYPH_ATLAS_LAST        126
+#define GLYPH_ATLAS_GLYPHS      (GLYPH_ATLAS_LAST - GLYPH_ATLAS_FIRST + 1)
+#define GLYPH_ATLAS_COLUMNS     16
+
+typedef struct {
+    float advance;
+    float texcoord[4];
+} Glyph;
+
+typedef struct {
+    GLuint tex;
+
+    int width;
+    int height;
+    int cellWidth;
+    int cellHeight;
+    int ascent;
+
+    Glyph glyphs[GLYPH_ATLAS_GLYPHS];
+} GlyphAtlas;
+
+GlyphAtlas* glyph_atlas_init(GlyphAtlas* a, const char* fontFace, double fontSize);
+void glyph_atlas_destroy(GlyphAtlas* atlas);
+
+Glyph* glyph_atlas_glyph(GlyphAtlas* atlas, char c);
+
+#endif // GLYPH_ATLAS_H
@@ -0,0 +1,243 @@
+#include "gpu_arena.h"
+#include "internal/gpu_arena.h"
+
+/* Linked list processing callbacks */
+
+char blocks_are_equal(void* blockAPtr, void* blockBPtr) {
+    return blockAPtr == blockBPtr;
+}
+
+/* GPU arena */
+
+GPUArena* gpu_arena_init(GPUArena* a, int vertexSize) {
+    GPUArena* arena = a ? a : NEW(GPUArena, 1);
+
+    arena->pages = NULL;
+    arena->pageCount = 0;
+    arena->vertexSize = vertexSize;
+
+    return arena;
+}
+
+void gpu_arena_destroy(GPUArena* arena) {
+    for (int p = 0; p < arena->pageCount; p++) {
+        GPUArenaPage* page = &arena->pages[p];
+
+        glDeleteBuffers(1, &page->origins);
+        glDeleteBuffers(1, &page->slots);
+        glDeleteBuffers(1, &page->vbo);
+
+        linked_list_destroy(&page->blocks, free);
+    }
+
+    free(arena->pages);
+}
+
+GPUArenaPage* gpu_arena_add_page(GPUArena* arena) {
+    arena->pages = realloc(arena->pages, (arena->pageCount + 1) * sizeof(GPUArenaPage));
+    GPUArenaPage* page = &arena->pages[arena->pageCount++];
+
+    linked_list_init(&page->blocks);
+    page->used = 0;
+    memset(page->slotUsed, 0, sizeof(page->slotUsed));
+
+    glGenBuffers(1, &page->vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, page->vbo);
+    glBufferData(GL_ARRAY_BUFFER, GPU_ARENA_PAGE_QUADS * 4 * arena->vertexSize, NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenBuffers(1, &page->slots);
+    glBindBuffer(GL_ARRAY_BUFFER, page->slots);
+    glBufferData(GL_ARRAY_BUFFER, GPU_ARENA_PAGE_QUADS * 4 * sizeof(GLushort), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenBuffers(1, &page->origins);
+    glBindBuffer(GL_UNIFORM_BUFFER, page->origins);
+    glBufferData(GL_UNIFORM_BUFFER, GPU_ARENA_PAGE_SLOTS * 4 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    return page;
+}
+
+GPUArenaBlock* gpu_arena_page_alloc(GPUArena* arena, int page, int count, float* origin) {
+    GPUArenaPage* arenaPage = &arena->pages[page];
+
+    if (GPU_ARENA_PAGE_QUADS - arenaPage->used < count)
+        return NULL;
+
+    int slot = 0;
+    while (slot < GPU_ARENA_PAGE_SLOTS && arenaPage->slotUsed[slot])
+        slot++;
+
+    if (slot == GPU_ARENA_PAGE_SLOTS)
+        return NULL;
+
+    // First fit among the gaps between blocks, which are kept in offset order
+    int cursor = 0;
+    LinkedListNode* node = arenaPage->blocks.head;
+    while (node) {
+        GPUArenaBlock* next = (GPUArenaBlock*)node->data;
+        if (next->first - cursor >= count)
+            break;
+
+        cursor = next->first + next->count;
+        node = node->next;
+    }
+
+    if (!node && GPU_ARENA_PAGE_QUADS - cursor < count)
+        return NULL;
+
+    GPUArenaBlock* block = NEW(GPUArenaBlock, 1);
+    block->page = page;
+    block->slot = slot;
+    block->first = cursor;
+    block->count = count;
+
+    if (node) {
+        linked_list_insert_before(&arenaPage->blocks, node, block);
+    } else {
+        linked_list_insert(&arenaPage->blocks, block);
+    }
+
+    arenaPage->used += count;
+    arenaPage->slotUsed[slot] = 1;
+
+    GLushort* slots = NEW(GLushort, count * 4);
+    for (int v = 0; v < count * 4; v++) {
+        slots[v] = slot;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, arenaPage->slots);
+    glBufferSubData(GL_ARRAY_BUFFER, cursor * 4 * sizeof(GLushort), count * 4 * sizeof(GLushort), slots);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    free(slots);
+
+    float slotOrigin[4] = { origin[0], origin[1], origin[2], 0 };
+
+    glBindBuffer(GL_UNIFORM_BUFFER, arenaPage->origins);
+    glBufferSubData(GL_UNIFORM_BUFFER, slot * sizeof(slotOrigin), sizeof(slotOrigin), slotOrigin);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    return block;
+}
+
+GPUArenaBlock* gpu_arena_alloc(GPUArena* arena, int count, float* origin) {
+    if (count <= 0 || count > GPU_ARENA_PAGE_QUADS)
+        return NULL;
+
+    for (int p = 0; p < arena->pageCount; p++) {
+        GPUArenaBlock* block = gpu_arena_page_alloc(arena, p, count, origin);
+        if (block)
+            return block;
+    }
+
+    gpu_arena_add_page(arena);
+
+    return gpu_arena_page_alloc(arena, arena->pageCount - 1, count, origin);
+}
+
+void gpu_arena_free(GPUArena* arena, GPUArenaBlock* block) {
+    GPUArenaPage* page = &arena->pages[block->page];
+
+    page->used -= block->count;
+    page->slotUsed[block->slot] = 0;
+    linked_list_remove(&page->blocks, linked_list_find(&page->blocks, block, blocks_are_equal), free);
+}
+
+void gpu_arena_upload(GPUArena* arena, GPUArenaBlock* block, int first, int count, void* data) {
+    glBindBuffer(GL_ARRAY_BUFFER, arena->pages[block->page].vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, (block->first + first) * 4 * arena->vertexSize, count * 4 * arena->vertexSize, data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void gpu_arena_copy(GLuint buffer, int quadSize, int from, int to, int count) {
+    int gap = from - to;
+
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+
+    // Copies within one buffer must not overlap, so slide the data down a gap at a time
+    for (int q = 0; q < count; q += gap) {
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                            (from + q) * quadSize,
+                            (to + q) * quadSize,
+                            MIN(gap, count - q) * quadSize);
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void gpu_arena_move(GPUArena* arena, GPUArenaBlock* block, int first) {
+    GPUArenaPage* page = &arena->pages[block->page];
+
+    gpu_arena_copy(page->vbo, 4 * arena->vertexSize, block->first, first, block->count);
+    gpu_arena_copy(page->slots, 4 * sizeof(GLushort), block->first, first, block->count);
+
+    block->first = first;
+}
+
+char gpu_arena_defragment(GPUArena* arena) {
+    // Compact the first page with holes, one page per call to bound the work
+    for (int p = 0; p < arena->pageCount; p++) {
+        GPUArenaPage* page = &arena->pages[p];
+
+        int cursor = 0;
+        LinkedListNode* node = page->blocks.head;
+        while (node && ((GPUArenaBlock*)node->data)->first == cursor) {
+            cursor += ((GPUArenaBlock*)node->data)->count;
+            node = node->next;
+        }
+
+        if (!node)
+            continue;
+
+        for (; node; node = node->next) {
+            GPUArenaBlock* block = (GPUArenaBlock*)node->data;
+
+            if (block->first != cursor)
+                gpu_arena_move(arena, block, cursor);
+
+            cursor += block->count;
+        }
+
+        return 1;
+    }
+
+    return 0;
+}
+
+GLuint gpu_arena_vbo(GPUArena* arena, GPUArenaBlock* block) {
+    return arena->pages[block->page].vbo;
+}
+
+GPUArenaStats* gpu_arena_stats(GPUArena* arena, GPUArenaStats* s) {
+    GPUArenaStats* stats = s ? s : NEW(GPUArenaStats, 1);
+
+    memset(stats, 0, sizeof(GPUArenaStats));
+
+    stats->pages = arena->pageCount;
+    stats->capacity = arena->pageCount * GPU_ARENA_PAGE_QUADS;
+
+    // Holes are free space between blocks; the free tail of a page is not fragmentation
+    for (int p = 0; p < arena->pageCount; p++) {
+        GPUArenaPage* page = &arena->pages[p];
+
+        int cursor = 0;
+        for (LinkedListNode* node = page->blocks.head; node; node = node->next) {
+            GPUArenaBlock* block = (GPUArenaBlock*)node->data;
+            stats->holes += block->first - cursor;
+            cursor = block->first + block->count;
+        }
+
+        stats->used += page->used;
+    }
+
+    int available = stats->capacity - stats->used;
+
+    stats->occupancy = stats->capacity ? (float)stats->used / stats->capacity : 0;
+    stats->fragmentation = available ? (float)stats->holes / available : 0;
+
+    return stats;
+}
@@ -0,0 +1,63 @@
+#ifndef GPU_ARENA_H
+#define GPU_ARENA_H
+
+#include <string.h>
+
+#include <GLES3/gl3.h>
+
+#include "global.h"
+#include "linked_list.h"
+
+// Space is handed out in quads of four vertices
+#define GPU_ARENA_PAGE_QUADS            (1 << 16)
+
+// Every vertex of a block carries the block's slot, which the vertex
+// shader uses to look up the block origin in the page's uniform buffer.
+// Must match the size of chunkOrigins in 3D.vert
+#define GPU_ARENA_PAGE_SLOTS            1024
+
+typedef struct {
+    int page;
+    int slot;
+    int first;
+    int count;
+} GPUArenaBlock;
+
+typedef struct {
+    GLuint vbo;
+    GLuint slots;
+    GLuint origins;
+    LinkedList blocks;
+    int used;
+    char slotUsed[GPU_ARENA_PAGE_SLOTS];
+} GPUArenaPage;
+
+typedef struct {
+    int pages;
+    int capacity;
+    int used;
+    int holes;
+    float occupancy;
+    float fragmentation;
+} GPUArenaStats;
+
+typedef struct {
+    GPUArenaPage* pages;
+    int pageCount;
+    int vertexSize;
+} GPUArena;
+
+GPUArena* gpu_arena_init(GPUArena* a, int vertexSize);
+void gpu_arena_destroy(GPUArena* arena);
+
+GPUArenaBlock* gpu_arena_alloc(GPUArena* arena, int count, float* origin);
+void gpu_arena_free(GPUArena* arena, GPUArenaBlock* block);
+
+void gpu_arena_upload(GPUArena* arena, GPUArenaBlock* block, int first, int count, void* data);
+char gpu_arena_defragment(GPUArena* arena);
+
+GLuint gpu_arena_vbo(GPUArena* arena, GPUArenaBlock* block);
+
+GPUArenaStats* gpu_arena_stats(GPUArena* arena, GPUArenaStats* stats);
+
+#endif // GPU_ARENA_H
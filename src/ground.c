@@ -5,7 +5,7 @@ Ground* ground_init(Ground* g, int length) {
 
     mesh_init(&ground->mesh);
 
-    Quad* quad = NEW(Quad, 1);
+    Quad quad;
 
     float backLeft[] = {
         -length/2, 0, -length/2
@@ -19,14 +19,15 @@ Ground* ground_init(Ground* g, int length) {
     float frontRight[] = {
         length/2, 0, length/2
     };
-    memcpy(quad->vertices[0].position, backLeft, sizeof(backLeft));
-    memcpy(quad->vertices[1].position, frontLeft, sizeof(frontLeft));
-    memcpy(quad->vertices[2].position, backRight, sizeof(backRight));
-    memcpy(quad->vertices[3].position, frontRight, sizeof(frontRight));
+    memcpy(quad.vertices[0].position, backLeft, sizeof(backLeft));
+    memcpy(quad.vertices[1].position, frontLeft, sizeof(frontLeft));
+    memcpy(quad.vertices[2].position, backRight, sizeof(backRight));
+    memcpy(quad.vertices[3].position, frontRight, sizeof(frontRight));
 
-    quad->orientation = TOP;
+    quad.orientation = TOP;
+    quad.color = 0;
 
-    mesh_add_quad(&ground->mesh, quad);
+    mesh_add_quad(&ground->mesh, &quad);
     mesh_calc_normals(&ground->mesh);
     mesh_buffer(&ground->mesh, MESH_FILL);
 
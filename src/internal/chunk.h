@@ -3,10 +3,20 @@
 
 #include "../chunk.h"
 
-/* Linked list processing callbacks */
+/* Helpers */
 
-void destroy_mesh(void* ptr);
-char meshes_are_equal(void* ptrA, void* ptrB);
-void prepare_mesh(void* node, void* rendererPtr);
+Chunk* chunk_neighbor(Chunk* chunk, Chunk** neighbors, int face);
+char chunk_neighbor_active(Chunk* neighbor, int d, int layer, int* x);
+
+int chunk_slice_count(Chunk* chunk);
+int chunk_slice_index(Chunk* chunk, int b, int d, int p);
+void chunk_invalidate_slice(Chunk* chunk, int b, int d, int p);
+
+void chunk_emit_quad(Mesh* mesh, int b, int d, int* x, int h, int w, uint16_t color);
+
+void chunk_mesh_masks(Chunk* chunk, Chunk** neighbors);
+void chunk_mesh_binary(Chunk* chunk, Chunk** neighbors);
+void chunk_slice_rows(Chunk* chunk, Chunk** neighbors, int b, int d, int p, uint64_t* rows);
+void chunk_merge_slice(Chunk* chunk, Mesh* mesh, int b, int d, int p, uint64_t* slice);
 
 #endif // CHUNK_INTERNAL_H
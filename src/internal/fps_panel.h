@@ -1,11 +1,11 @@
 #ifndef FPS_PANEL_INTERNAL_H
 #define FPS_PANEL_INTERNAL_H
 
-#define FPS_PANEL_WIDTH     128
-#define FPS_PANEL_HEIGHT     16
+#define FPS_PANEL_WIDTH     192
+#define FPS_PANEL_HEIGHT    128
 
 #include "../fps_panel.h"
 
-void fps_panel_draw(void* fpsPanelPtr);
+void fps_panel_format(FPSPanel* fpsPanel);
 
 #endif // FPS_PANEL_INTERNAL_H
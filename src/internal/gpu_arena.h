@@ -0,0 +1,17 @@
+#ifndef GPU_ARENA_INTERNAL_H
+#define GPU_ARENA_INTERNAL_H
+
+#include "../gpu_arena.h"
+
+/* Linked list processing callbacks */
+
+char blocks_are_equal(void* blockAPtr, void* blockBPtr);
+
+/* GPU arena */
+
+GPUArenaPage* gpu_arena_add_page(GPUArena* arena);
+GPUArenaBlock* gpu_arena_page_alloc(GPUArena* arena, int page, int count, float* origin);
+void gpu_arena_copy(GLuint buffer, int quadSize, int from, int to, int count);
+void gpu_arena_move(GPUArena* arena, GPUArenaBlock* block, int first);
+
+#endif // GPU_ARENA_INTERNAL_H
@@ -4,5 +4,13 @@
 #include "../mesh.h"
 
 void mesh_ortn_to_normal(char orientation, float* nvec);
+int mesh_vertex_size(Mesh* mesh);
+char mesh_buffer_arena(Mesh* mesh);
+void* mesh_scratch(void** scratch, size_t* capacity, size_t size);
+
+void quad_set_normals(Quad* quad);
+
+void mesh_write_quad_float(float* vertex_data, Quad* quad);
+void mesh_write_quad_packed(GLuint* vertex_data, Quad* quad);
 
 #endif // MESH_INTERNAL_H
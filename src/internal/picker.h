@@ -4,6 +4,9 @@
 #include "../picker.h"
 
 void picker_act(Picker* picker, char modifier1, char modifier2);
+void picker_paint(Picker* picker);
+int* picker_stroke_cell(Picker* picker, float* origin, float* direction, int* cell);
 Box picker_merge_selections(Box* selectionA, Box* selectionB);
+void picker_drop_model(Picker* picker);
 
 #endif // PICKER_INTERNAL_H
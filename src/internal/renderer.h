@@ -21,19 +21,30 @@ void renderer_3D_update_ambient(Renderer* renderer, float a);
 void renderer_3D_update_sun_position(Renderer* renderer, float* position);
 
 void renderer_3D_use(Renderer* renderer);
+void renderer_3D_upload_frame(Renderer* renderer);
 
 void renderer_2D_update_projection(Renderer* renderer, float* mat4);
 void renderer_2D_update_sampler(Renderer* renderer, GLint sampler);
 
 void renderer_2D_use(Renderer* renderer);
 
-void render_mesh(void* ptr, void* rendererPtr);
+int compare_batches(const void* batchAPtr, const void* batchBPtr);
+
+void count_world_chunk(void* worldChunkPtr, void* rendererPtr);
 void render_world_chunk(void* worldChunkPtr, void* rendererPtr);
 void render_panel(void* panelPtr, void* rendererPtr);
 
+void renderer_chunk_box(Box* box, WorldChunk* worldChunk);
+void renderer_bind_quad_indices(Renderer* renderer, char mode, int quads);
+
 void renderer_render_ground(Renderer* renderer, Ground* ground, Camera* camera);
 void renderer_render_mesh(Renderer* renderer, Mesh* mesh, char mode);
+void renderer_render_box(Renderer* renderer, Box* box);
+void renderer_render_mesh_ranges(Renderer* renderer, Mesh* mesh, char mode, MeshRange* ranges, int count);
 void renderer_render_chunk(Renderer* renderer, Chunk* chunk, float* position);
+void renderer_render_chunk_faces(Renderer* renderer, Chunk* chunk, float* position);
+void renderer_queue_mesh_ranges(Renderer* renderer, Mesh* mesh, MeshRange* ranges, int count);
+void renderer_render_batches(Renderer* renderer, GPUArena* arena);
 void renderer_render_panel(Renderer* renderer, Panel* panel);
 
 #endif // RENDERER_INTERNAL_H
@@ -3,10 +3,13 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "../shader.h"
 
 GLuint shader_create(const char* path, GLenum shaderType);
 GLuint shader_create_program(GLuint vertex_shader, GLuint fragment_shader);
 
+char shader_sent(void* sent, const void* value, size_t size);
+
 #endif // SHADER_INTERNAL_H
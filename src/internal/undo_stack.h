@@ -0,0 +1,22 @@
+#ifndef UNDO_STACK_INTERNAL_H
+#define UNDO_STACK_INTERNAL_H
+
+#include "../undo_stack.h"
+
+/* Linked list processing callbacks */
+
+void destroy_command(void* commandPtr);
+int compare_spill_addresses(const void* commandAPtr, const void* commandBPtr);
+
+/* Undo stack */
+
+void undo_stack_remove(UndoStack* stack, LinkedListNode* node);
+void undo_stack_drop_older(UndoStack* stack, LinkedListNode* node);
+void undo_stack_drop_newer(UndoStack* stack, LinkedListNode* node);
+bool undo_stack_spill(UndoStack* stack, Command* command);
+bool undo_stack_page_in(UndoStack* stack, LinkedListNode* node);
+void undo_stack_release(UndoStack* stack, Command* command);
+void undo_stack_compact(UndoStack* stack);
+void undo_stack_trim(UndoStack* stack);
+
+#endif // UNDO_STACK_INTERNAL_H
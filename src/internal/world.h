@@ -3,20 +3,72 @@
 
 #include "../world.h"
 
+typedef struct {
+    ChunkID id;
+    int entryFace;
+    uint8_t directions;
+} VisibilityStep;
+
+// Grid traversal state: the cell the ray is in and the distances at which
+// it crosses the next cell boundary along each axis
+typedef struct {
+    int cell[3];
+    int step[3];
+    float tMax[3];
+    float tDelta[3];
+    float t;
+    int axis;
+} WorldRay;
+
+// A destination chunk of a chunk blit, with the bounds of the blocks
+// written into it so it is invalidated once
+typedef struct {
+    ChunkID id;
+    WorldChunk* worldChunk;
+    char found;
+    int low[3];
+    int high[3];
+    char shapeChanged;
+} WorldBlitTarget;
+
 /* Linked list processing callbacks */
 
 void load_world_chunk(void* chunkIDPtr, void* worldPtr);
 void unload_world_chunk(void* worldChunkPtr, void* worldPtr);
 char chunk_id_equals_world_chunk(void* chunkIDPtr, void* worldChunkPtr);
+void remesh_world_chunk(void* worldChunkPtr, void* worldPtr);
 void destroy_world_chunk(void* worldChunkPtr);
 int compare_chunk_ids(ChunkID* chunkIDA, ChunkID* chunkIDB);
 int compare_world_chunks(void* worldChunkAPtr, void* worldChunkBPtr);
+ChunkID* chunk_id_neighbor(ChunkID* neighborID, ChunkID* chunkID, int face);
+unsigned int hash_chunk_id(ChunkID* chunkID);
 
 /* World */
 
+void world_insert_world_chunk(World* world, WorldChunk* worldChunk);
 Chunk* world_load_world_chunk(World* world, ChunkID* chunkID);
 void world_unload_world_chunk(World* world, WorldChunk* worldChunk);
+WorldChunk* world_find_world_chunk(World* world, ChunkID* chunkID, char create);
+
+void world_mesh_world_chunk(World* world, WorldChunk* worldChunk);
+void world_invalidate_face(World* world, ChunkID* chunkID, int face);
+void world_invalidate_block(World* world, WorldChunk* worldChunk, int* block_position);
+void world_invalidate_blocks(World* world, WorldChunk* worldChunk, int* low, int* high);
+
+WorldChunk* world_locate_block(World* world, WorldChunk* worldChunk, int* location, int* block_position, char create);
+void world_write_block(World* world, WorldChunk* worldChunk, int* block_position, uint16_t data);
+WorldChunk* world_edit_block(World* world, WorldChunk* worldChunk, int* location, char active, uint16_t color, WorldDelta* delta);
+Chunk* world_read_region(World* world, Box* box, char cut);
+void world_blit_row(World* world, WorldBlitTarget* target, Chunk* chunk, int* location, int rotation, int* rowLocation, int length, WorldDelta* delta);
+
+void world_load_chunks(World* world, ChunkID* center);
+
+LinkedList* world_load_list(World* world, LinkedList* list, ChunkID* center);
+
+char world_chunk_is_empty(WorldChunk* worldChunk);
 
-LinkedList* world_draw_list(LinkedList* list, Camera* camera);
+void world_ray_init(WorldRay* ray, float* origin, float* direction, float cellSize, float t, int* low, int* high);
+void world_ray_step(WorldRay* ray);
+void world_ray_hit(WorldRay* ray, WorldRayHit* hit);
 
 #endif // WORLD_INTERNAL_H
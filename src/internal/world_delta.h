@@ -0,0 +1,22 @@
+#ifndef WORLD_DELTA_INTERNAL_H
+#define WORLD_DELTA_INTERNAL_H
+
+#include "../world_delta.h"
+
+// Walks the changed cells of a delta in order, numbered in another region
+typedef struct {
+    WorldDelta* delta;
+    int span;
+    int cell;
+    int index;
+} WorldDeltaCursor;
+
+char world_delta_covers(WorldDelta* delta, WorldDelta* other);
+char world_delta_splice(WorldDelta* delta, WorldDelta* newer);
+int world_delta_search(WorldDelta* delta, int index);
+void world_delta_combine(WorldDelta* merged, WorldDelta* older, WorldDelta* newer);
+
+void world_delta_cursor_init(WorldDeltaCursor* cursor, WorldDelta* delta, WorldDelta* target);
+void world_delta_cursor_next(WorldDeltaCursor* cursor, WorldDelta* target);
+
+#endif // WORLD_DELTA_INTERNAL_H
@@ -29,24 +29,21 @@ float* mat3_sub(float* mat2d, float* mat3s, unsigned int i) {
 }
 
 float* mat3_transpose(float* mat3d, float* mat3s) {
-    float* mat3t = NEW(float, 9);
+    float mat3t[9];
 
     for (unsigned i=0; i<3; i++)
         for (unsigned j=0; j<3; j++)
             mat3t[i*3+j] = mat3s[j*3+i];
 
-    if (mat3d) {
-        memcpy(mat3d, mat3t, 9*sizeof(float));
-        free(mat3t);
-    } else {
-        mat3d = mat3t;
-    }
+    if (!mat3d)
+        mat3d = NEW(float, 9);
+    memcpy(mat3d, mat3t, 9*sizeof(float));
 
     return mat3d;
 }
 
 float* mat3_inverse(float* mat3d, float* mat3s) {
-    float* mat3m = NEW(float, 9);
+    float mat3m[9];
     float  mat2[4];
 
     for (unsigned i=0; i<9; i++) {
@@ -68,12 +65,9 @@ float* mat3_inverse(float* mat3d, float* mat3s) {
     for (unsigned i=0; i<9; i++)
         mat3m[i] /= det;
 
-    if (mat3d) {
-        memcpy(mat3d, mat3m, 9*sizeof(float));
-        free(mat3m);
-    } else {
-        mat3d = mat3m;
-    }
+    if (!mat3d)
+        mat3d = NEW(float, 9);
+    memcpy(mat3d, mat3m, 9*sizeof(float));
 
     return mat3d;
 }
@@ -119,58 +113,67 @@ float* mat4_sub(float* mat3d, float* mat4s, unsigned int i) {
 }
 
 float* mat4_transpose(float* mat4d, float* mat4s) {
-    float* mat4t = NEW(float, 16);
+    float mat4t[16];
 
     for (unsigned i=0; i<4; i++)
         for (unsigned j=0; j<4; j++)
             mat4t[i*4+j] = mat4s[j*4+i];
 
-    if (mat4d) {
-        memcpy(mat4d, mat4t, 16*sizeof(float));
-        free(mat4t);
-    } else {
-        mat4d = mat4t;
-    }
+    if (!mat4d)
+        mat4d = NEW(float, 16);
+    memcpy(mat4d, mat4t, 16*sizeof(float));
 
     return mat4d;
 }
 
 
 float* mat4_inverse(float* mat4d, float* mat4s) {
-    float* mat4m = NEW(float, 16);
-    float  mat3[9];
-
-    for (unsigned i=0; i<16; i++) {
-        mat4_sub(mat3, mat4s, i);
-        mat4m[i] = mat3_determinate(mat3);
-    }
-
-    float det = mat4s[0]*mat4m[0] - mat4s[1]*mat4m[1] + mat4s[2]*mat4m[2] - mat4s[3]*mat4m[3];
-
-    // Cofactors
-    for (unsigned i=0; i<16; i++) {
-        if ((i / 4) % 2 == 1)
-            if (i % 2 == 0)
-                mat4m[i] = -mat4m[i];
-
-        if ((i / 4) % 2 == 0)
-            if (i % 2 == 1)
-                mat4m[i] = -mat4m[i];
-    }
+    float* m = mat4s;
+    float mat4m[16];
+
+    // Closed form: every cofactor is built from the 2x2 determinants of the
+    // first two and the last two columns
+    float s0 = m[0]*m[5] - m[4]*m[1];
+    float s1 = m[0]*m[6] - m[4]*m[2];
+    float s2 = m[0]*m[7] - m[4]*m[3];
+    float s3 = m[1]*m[6] - m[5]*m[2];
+    float s4 = m[1]*m[7] - m[5]*m[3];
+    float s5 = m[2]*m[7] - m[6]*m[3];
+
+    float c0 = m[8]*m[13]  - m[12]*m[9];
+    float c1 = m[8]*m[14]  - m[12]*m[10];
+    float c2 = m[8]*m[15]  - m[12]*m[11];
+    float c3 = m[9]*m[14]  - m[13]*m[10];
+    float c4 = m[9]*m[15]  - m[13]*m[11];
+    float c5 = m[10]*m[15] - m[14]*m[11];
+
+    float det = s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+
+    mat4m[0]  = ( m[5]*c5  - m[6]*c4  + m[7]*c3);
+    mat4m[1]  = (-m[1]*c5  + m[2]*c4  - m[3]*c3);
+    mat4m[2]  = ( m[13]*s5 - m[14]*s4 + m[15]*s3);
+    mat4m[3]  = (-m[9]*s5  + m[10]*s4 - m[11]*s3);
+
+    mat4m[4]  = (-m[4]*c5  + m[6]*c2  - m[7]*c1);
+    mat4m[5]  = ( m[0]*c5  - m[2]*c2  + m[3]*c1);
+    mat4m[6]  = (-m[12]*s5 + m[14]*s2 - m[15]*s1);
+    mat4m[7]  = ( m[8]*s5  - m[10]*s2 + m[11]*s1);
+
+    mat4m[8]  = ( m[4]*c4  - m[5]*c2  + m[7]*c0);
+    mat4m[9]  = (-m[0]*c4  + m[1]*c2  - m[3]*c0);
+    mat4m[10] = ( m[12]*s4 - m[13]*s2 + m[15]*s0);
+    mat4m[11] = (-m[8]*s4  + m[9]*s2  - m[11]*s0);
+
+    mat4m[12] = (-m[4]*c3  + m[5]*c1  - m[6]*c0);
+    mat4m[13] = ( m[0]*c3  - m[1]*c1  + m[2]*c0);
+    mat4m[14] = (-m[12]*s3 + m[13]*s1 - m[14]*s0);
+    mat4m[15] = ( m[8]*s3  - m[9]*s1  + m[10]*s0);
+
+    if (!mat4d)
+        mat4d = NEW(float, 16);
 
-    // Adjugate
-    mat4_transpose(mat4m, mat4m);
-
-    // Multiply by 1/Determinant
     for (unsigned i=0; i<16; i++)
-        mat4m[i] /= det;
-
-    if (mat4d) {
-        memcpy(mat4d, mat4m, 16*sizeof(float));
-        free(mat4m);
-    } else {
-        mat4d = mat4m;
-    }
+        mat4d[i] = mat4m[i] / det;
 
     return mat4d;
 }
@@ -199,7 +202,8 @@ float* mat4_identity(float* mat4d) {
 }
 
 float* mat4_translate(float* mat4d, float* mat4s, float* vec3) {
-    float* mat4t = mat4_identity(NULL);
+    float mat4t[16];
+    mat4_identity(mat4t);
 
     for (unsigned i=0; i<3; i++)
         mat4t[12+i] = vec3[i];
@@ -207,18 +211,33 @@ float* mat4_translate(float* mat4d, float* mat4s, float* vec3) {
     if (mat4s)
         mat4_multiply(mat4t, mat4s, mat4t);
 
-    if (mat4d) {
-        memcpy(mat4d, mat4t, 16*sizeof(float));
-        free(mat4t);
-    } else {
-        mat4d = mat4t;
-    }
+    if (!mat4d)
+        mat4d = NEW(float, 16);
+    memcpy(mat4d, mat4t, 16*sizeof(float));
+
+    return mat4d;
+}
+
+float* mat4_scale(float* mat4d, float* mat4s, float* vec3) {
+    float mat4t[16];
+    mat4_identity(mat4t);
+
+    for (unsigned i=0; i<3; i++)
+        mat4t[5*i] = vec3[i];
+
+    if (mat4s)
+        mat4_multiply(mat4t, mat4s, mat4t);
+
+    if (!mat4d)
+        mat4d = NEW(float, 16);
+    memcpy(mat4d, mat4t, 16*sizeof(float));
 
     return mat4d;
 }
 
 float* mat4_rotate(float* mat4d, float* mat4s, float radians, float* vec3) {
-    float* mat4r = mat4_identity(NULL);
+    float mat4r[16];
+    mat4_identity(mat4r);
 
     float u = vec3[0];
     float v = vec3[1];
@@ -254,29 +273,39 @@ float* mat4_rotate(float* mat4d, float* mat4s, float radians, float* vec3) {
     if (mat4s)
         mat4_multiply(mat4r, mat4s, mat4r);
 
-    if (mat4d) {
-        memcpy(mat4d, mat4r, 16*sizeof(float));
-        free(mat4r);
-    } else {
-        mat4d = mat4r;
-    }
+    if (!mat4d)
+        mat4d = NEW(float, 16);
+    memcpy(mat4d, mat4r, 16*sizeof(float));
 
     return mat4d;
 }
 
 float* mat4_multiply(float* mat4d, float* mat4a, float* mat4b) {
-    float* mat4m = NEW(float, 16);
+    float mat4m[16];
+
+#ifdef __SSE__
+    __m128 a0 = _mm_loadu_ps(&mat4a[0]);
+    __m128 a1 = _mm_loadu_ps(&mat4a[4]);
+    __m128 a2 = _mm_loadu_ps(&mat4a[8]);
+    __m128 a3 = _mm_loadu_ps(&mat4a[12]);
 
+    // Each column of the product is the columns of a weighted by a column of b
+    for (unsigned i=0; i<4; i++) {
+        __m128 column = _mm_mul_ps(a0, _mm_set1_ps(mat4b[i*4+0]));
+        column = _mm_add_ps(column, _mm_mul_ps(a1, _mm_set1_ps(mat4b[i*4+1])));
+        column = _mm_add_ps(column, _mm_mul_ps(a2, _mm_set1_ps(mat4b[i*4+2])));
+        column = _mm_add_ps(column, _mm_mul_ps(a3, _mm_set1_ps(mat4b[i*4+3])));
+        _mm_storeu_ps(&mat4m[i*4], column);
+    }
+#else
     for (unsigned i=0; i<4; i++)
         for (unsigned j=0; j<4; j++)
             mat4m[i*4+j] = mat4a[0+j]*mat4b[i*4+0] + mat4a[4+j]*mat4b[i*4+1] + mat4a[8+j]*mat4b[i*4+2]  + mat4a[12+j]*mat4b[i*4+3];
+#endif
 
-    if (mat4d) {
-        memcpy(mat4d, mat4m, 16*sizeof(float));
-        free(mat4m);
-    } else {
-        mat4d = mat4m;
-    }
+    if (!mat4d)
+        mat4d = NEW(float, 16);
+    memcpy(mat4d, mat4m, 16*sizeof(float));
 
     return mat4d;
 }
@@ -338,23 +367,28 @@ float* vec3_scale(float* vec3d, float* vec3s, float m) {
 }
 
 float* vec3_transform(float* vec3d, float* mat4, float* vec3s) {
-    float* vec3t  = NEW(float, 3);
-
+    float vec3t[4];
+
+#ifdef __SSE__
+    __m128 vec = _mm_mul_ps(_mm_loadu_ps(&mat4[0]), _mm_set1_ps(vec3s[0]));
+    vec = _mm_add_ps(vec, _mm_mul_ps(_mm_loadu_ps(&mat4[4]), _mm_set1_ps(vec3s[1])));
+    vec = _mm_add_ps(vec, _mm_mul_ps(_mm_loadu_ps(&mat4[8]), _mm_set1_ps(vec3s[2])));
+    vec = _mm_add_ps(vec, _mm_loadu_ps(&mat4[12]));
+    _mm_storeu_ps(vec3t, vec);
+#else
     for (unsigned i=0; i<3; i++)
         vec3t[i] = vec3s[0]*mat4[i+0] + vec3s[1]*mat4[i+4] + vec3s[2]*mat4[i+8] + mat4[i+12];
+#endif
 
-    if (vec3d) {
-        memcpy(vec3d, vec3t, 3*sizeof(float));
-        free(vec3t);
-    } else {
-        vec3d = vec3t;
-    }
+    if (!vec3d)
+        vec3d = NEW(float, 3);
+    memcpy(vec3d, vec3t, 3*sizeof(float));
 
     return vec3d;
 }
 
 float* vec3_normalize(float* vec3d, float* vec3s) {
-    float* vec3n  = NEW(float, 3);
+    float vec3n[3];
     memcpy(vec3n, vec3s, 3*sizeof(float));
 
     float length = sqrt(pow(vec3s[0], 2) + pow(vec3s[1], 2) + pow(vec3s[2], 2));
@@ -362,28 +396,30 @@ float* vec3_normalize(float* vec3d, float* vec3s) {
     for (int i=0; i<3; i++)
         vec3n[i] /= length;
 
-    if (vec3d) {
-        memcpy(vec3d, vec3n, 3*sizeof(float));
-        free(vec3n);
-    } else {
-        vec3d = vec3n;
-    }
+    if (!vec3d)
+        vec3d = NEW(float, 3);
+    memcpy(vec3d, vec3n, 3*sizeof(float));
 
-    return vec3n;
+    return vec3d;
 }
 
 float* vec4_transform(float* vec4d, float* mat4, float* vec4s) {
-    float* vec4t  = NEW(float, 4);
-
+    float vec4t[4];
+
+#ifdef __SSE__
+    __m128 vec = _mm_mul_ps(_mm_loadu_ps(&mat4[0]), _mm_set1_ps(vec4s[0]));
+    vec = _mm_add_ps(vec, _mm_mul_ps(_mm_loadu_ps(&mat4[4]), _mm_set1_ps(vec4s[1])));
+    vec = _mm_add_ps(vec, _mm_mul_ps(_mm_loadu_ps(&mat4[8]), _mm_set1_ps(vec4s[2])));
+    vec = _mm_add_ps(vec, _mm_mul_ps(_mm_loadu_ps(&mat4[12]), _mm_set1_ps(vec4s[3])));
+    _mm_storeu_ps(vec4t, vec);
+#else
     for (unsigned i=0; i<4; i++)
         vec4t[i] = vec4s[0]*mat4[i+0] + vec4s[1]*mat4[i+4] + vec4s[2]*mat4[i+8] + vec4s[3]*mat4[i+12];
+#endif
 
-    if (vec4d) {
-        memcpy(vec4d, vec4t, 4*sizeof(float));
-        free(vec4t);
-    } else {
-        vec4d = vec4t;
-    }
+    if (!vec4d)
+        vec4d = NEW(float, 4);
+    memcpy(vec4d, vec4t, 4*sizeof(float));
 
     return vec4d;
 }
@@ -5,6 +5,10 @@
 #include <string.h>
 #include <math.h>
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 #include "global.h"
 
 float mat2_determinate(float* mat2s);
@@ -21,6 +25,7 @@ float mat4_determinate(float* mat4s);
 
 float* mat4_identity(float* mat4d);
 float* mat4_translate(float* mat4d, float* mat4s, float* vec3);
+float* mat4_scale(float* mat4d, float* mat4s, float* vec3);
 float* mat4_rotate(float* mat4d, float* mat4s, float radians, float* vec3);
 float* mat4_multiply(float* mat4d, float* mat4a, float* mat4b);
 float* mat4_perspective(float* mat4d, float fov, float aspect, float near, float far);
@@ -39,13 +39,41 @@ void mesh_ortn_to_normal(char orientation, float* nvec) {
     }
 }
 
-void mesh_add_quad(Mesh* mesh, Quad* quad) {
-    linked_list_insert(&mesh->quads, quad);
+void mesh_write_quad_float(float* vertex_data, Quad* quad) {
+    float color[3];
+    block_color_rgb(quad->color, color);
+
+    for (int v=0; v<4; v++) {
+        for (int p=0; p<3; p++)
+            vertex_data[v*9+0+p] = quad->vertices[v].position[p];
+        for (int n=0; n<3; n++)
+            vertex_data[v*9+3+n] = quad->vertices[v].normal_v[n];
+        for (int c=0; c<3; c++)
+            vertex_data[v*9+6+c] = color[c] / 255.0;
+    }
+}
+
+void mesh_write_quad_packed(GLuint* vertex_data, Quad* quad) {
+    for (int v=0; v<4; v++) {
+        float* position = quad->vertices[v].position;
+        vertex_data[v] = MESH_PACK_VERTEX(position[0], position[1], position[2], quad->orientation, quad->color);
+    }
+}
+
+int mesh_vertex_size(Mesh* mesh) {
+    return mesh->format == MESH_FORMAT_PACKED ? sizeof(GLuint) : 9*sizeof(float);
 }
 
-void quad_set_normals(void* ptr, void* unused) {
-    Quad* quad = (Quad*)ptr;
+void* mesh_scratch(void** scratch, size_t* capacity, size_t size) {
+    if (size > *capacity) {
+        *capacity = MAX(size, *capacity * 2);
+        *scratch = realloc(*scratch, *capacity);
+    }
+
+    return *scratch;
+}
 
+void quad_set_normals(Quad* quad) {
     float normal[3];
     mesh_ortn_to_normal(quad->orientation, normal);
     for (int v = 0; v < 4; v++) {
@@ -60,58 +88,173 @@ void quad_set_normals(void* ptr, void* unused) {
 Mesh* mesh_init(Mesh* m) {
     Mesh* mesh = m ? m : NEW(Mesh, 1);
 
-    linked_list_init(&mesh->quads);
+    mesh->quads.data = NULL;
+    mesh->quads.size = 0;
+    mesh->quads.capacity = 0;
+
+    mesh->vbo = 0;
+    mesh->elements = 0;
+    mesh->bufferCapacity = 0;
+    mesh->mode = MESH_FILL;
+    mesh->format = MESH_FORMAT_FLOAT;
 
-    glGenBuffers(1, &mesh->vbo);
-    glGenBuffers(1, &mesh->ebo);
+    mesh->arena = NULL;
+    mesh->block = NULL;
+    memset(mesh->origin, 0, sizeof(mesh->origin));
 
     return mesh;
 }
 
 void mesh_destroy(Mesh* mesh) {
-    glDeleteBuffers(1, &mesh->ebo);
+    if (mesh->block)
+        gpu_arena_free(mesh->arena, mesh->block);
+
     glDeleteBuffers(1, &mesh->vbo);
 
-    linked_list_destroy(&mesh->quads, free);
+    free(mesh->quads.data);
+}
+
+void mesh_clear(Mesh* mesh) {
+    // Keep the quad storage around for the next remesh
+    mesh->quads.size = 0;
+}
+
+Quad* mesh_new_quad(Mesh* mesh) {
+    QuadArray* quads = &mesh->quads;
+
+    if (quads->size == quads->capacity) {
+        quads->capacity = quads->capacity ? quads->capacity * 2 : 64;
+        quads->data = realloc(quads->data, quads->capacity * sizeof(Quad));
+    }
+
+    return &quads->data[quads->size++];
+}
+
+void mesh_add_quad(Mesh* mesh, Quad* quad) {
+    *mesh_new_quad(mesh) = *quad;
+}
+
+void mesh_add_quads(Mesh* mesh, Quad* quads, int count) {
+    QuadArray* array = &mesh->quads;
+
+    if (array->size + count > array->capacity) {
+        array->capacity = MAX(array->size + count, array->capacity * 2);
+        array->data = realloc(array->data, array->capacity * sizeof(Quad));
+    }
+
+    memcpy(&array->data[array->size], quads, count * sizeof(Quad));
+    array->size += count;
 }
 
 void mesh_calc_normals(Mesh* mesh) {
-    linked_list_foreach(&mesh->quads, quad_set_normals, NULL);
+    for (int q = 0; q < mesh->quads.size; q++) {
+        quad_set_normals(&mesh->quads.data[q]);
+    }
+}
+
+void mesh_set_arena(Mesh* mesh, GPUArena* arena, float* origin) {
+    mesh->arena = arena;
+    memcpy(mesh->origin, origin, sizeof(mesh->origin));
+}
+
+char mesh_buffer_arena(Mesh* mesh) {
+    // The arena holds packed triangle meshes only
+    if (!mesh->arena || mesh->format != MESH_FORMAT_PACKED || mesh->mode != MESH_FILL)
+        return 0;
+
+    int capacity = MAX(mesh->quads.size, mesh->quads.capacity);
+
+    if (mesh->block && mesh->block->count != capacity) {
+        gpu_arena_free(mesh->arena, mesh->block);
+        mesh->block = NULL;
+    }
+
+    if (!mesh->quads.size) {
+        if (mesh->block)
+            gpu_arena_free(mesh->arena, mesh->block);
+        mesh->block = NULL;
+        mesh->bufferCapacity = 0;
+        mesh->elements = 0;
+        return 1;
+    }
+
+    if (!mesh->block)
+        mesh->block = gpu_arena_alloc(mesh->arena, capacity, mesh->origin);
+
+    if (!mesh->block)
+        return 0;
+
+    mesh->bufferCapacity = capacity;
+
+    return 1;
 }
 
 void mesh_buffer(Mesh* mesh, char mode) {
-    int num_elements_f = mesh->quads.size * 4;
-    int num_vertices_f = num_elements_f * 6;
-    float* vertex_data = NEW(float, num_vertices_f);
-    GLushort*  elements    = NEW(GLushort, num_elements_f);
-
-    LinkedListNode* node = mesh->quads.head;
-    for (int q=0; node; q++, node = node->next) {
-        Quad* quad = (Quad*)node->data;
-        for (int v=0; v<4; v++) {
-            for (int p=0; p<3; p++)
-                vertex_data[q*24+v*6+0+p] = quad->vertices[v].position[p];
-            for (int n=0; n<3; n++)
-                vertex_data[q*24+v*6+3+n] = quad->vertices[v].normal_v[n];
-
-            int order[] = {
-                0,
-                1,
-                mode == MESH_FILL ? 2 : 3,
-                mode == MESH_FILL ? 3 : 2,
-            };
-
-            elements[q*4+v] = q*4 + order[v];
-        }
+    mesh->mode = mode;
+
+    if (mesh_buffer_arena(mesh)) {
+        if (mesh->quads.size)
+            mesh_buffer_range(mesh, 0);
+        return;
     }
 
+    int vertex_size = mesh_vertex_size(mesh);
+
+    // Reserve room for the whole quad array so later edits can be patched in place.
+    // Indices come from the renderer's shared quad index buffers
+    int capacity = MAX(mesh->quads.size, mesh->quads.capacity);
+
+    mesh->bufferCapacity = capacity;
+
+    if (!mesh->vbo)
+        glGenBuffers(1, &mesh->vbo);
+
     glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
-    glBufferData(GL_ARRAY_BUFFER, num_vertices_f*sizeof(float), vertex_data, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, capacity * 4 * vertex_size, NULL, GL_DYNAMIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, num_elements_f*sizeof(GLushort), elements, GL_STATIC_DRAW);
+    mesh_buffer_range(mesh, 0);
+}
+
+void mesh_buffer_range(Mesh* mesh, int first) {
+    if ((!mesh->vbo && !mesh->block) || mesh->quads.size > mesh->bufferCapacity) {
+        mesh_buffer(mesh, mesh->mode);
+        return;
+    }
+
+    int vertex_size = mesh_vertex_size(mesh);
 
-    free(elements);
-    free(vertex_data);
+    // Staging array is shared by every mesh and only ever grows
+    static void* vertex_scratch = NULL;
+    static size_t vertex_scratch_capacity = 0;
+
+    int count = mesh->quads.size - first;
+    char* vertex_data = mesh_scratch(&vertex_scratch, &vertex_scratch_capacity, count * 4 * vertex_size);
+
+    for (int q=0; q < count; q++) {
+        Quad* quad = &mesh->quads.data[first + q];
+
+        if (mesh->format == MESH_FORMAT_PACKED) {
+            mesh_write_quad_packed((GLuint*)vertex_data + q*4, quad);
+        } else {
+            mesh_write_quad_float((float*)vertex_data + q*36, quad);
+        }
+    }
+
+    mesh->elements = mesh->quads.size * (mesh->mode == MESH_FILL ? MESH_FILL_ELEMENTS_PER_QUAD : MESH_LINE_ELEMENTS_PER_QUAD);
+
+    if (mesh->block) {
+        gpu_arena_upload(mesh->arena, mesh->block, first, count, vertex_data);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+        glBufferSubData(GL_ARRAY_BUFFER, first * 4 * vertex_size, count * 4 * vertex_size, vertex_data);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
 }
 
+GLuint mesh_vbo(Mesh* mesh) {
+    return mesh->block ? gpu_arena_vbo(mesh->arena, mesh->block) : mesh->vbo;
+}
+
+int mesh_first_quad(Mesh* mesh) {
+    return mesh->block ? mesh->block->first : 0;
+}
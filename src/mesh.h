@@ -3,11 +3,13 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <GLES3/gl3.h>
 
 #include "global.h"
-#include "linked_list.h"
+#include "block.h"
+#include "gpu_arena.h"
 
 #define NORTH           0
 #define SOUTH           1
@@ -19,6 +21,18 @@
 #define MESH_FILL       1
 #define MESH_LINE       2
 
+#define MESH_FILL_ELEMENTS_PER_QUAD     6
+#define MESH_LINE_ELEMENTS_PER_QUAD     8
+
+#define MESH_FORMAT_FLOAT       1
+#define MESH_FORMAT_PACKED      2
+
+// Packed vertices fit in one 32-bit word:
+// x, y, z (6 bits each), orientation (3 bits), block color (9 bits)
+#define MESH_PACKED_POSITION_MAX        63
+#define MESH_PACK_VERTEX(x, y, z, orientation, color) \
+    ((GLuint)(x) | ((GLuint)(y) << 6) | ((GLuint)(z) << 12) | ((GLuint)(orientation) << 18) | ((GLuint)(color) << 21))
+
 typedef struct {
     float position[3];
     float normal_v[3];
@@ -27,22 +41,49 @@ typedef struct {
 typedef struct {
     Vertex vertices[4];
     char orientation;
+    uint16_t color;
 } Quad;
 
 typedef struct {
-    uint16_t color;
-    LinkedList quads;
+    Quad* data;
+    int size;
+    int capacity;
+} QuadArray;
+
+typedef struct {
+    int first;
+    int count;
+} MeshRange;
+
+typedef struct {
+    QuadArray quads;
 
     GLuint vbo;
-    GLuint ebo;
+    GLsizei elements;
+    int bufferCapacity;
+    char mode;
+    char format;
+
+    GPUArena* arena;
+    GPUArenaBlock* block;
+    float origin[3];
 } Mesh;
 
 Mesh* mesh_init(Mesh* m);
 void mesh_destroy(Mesh* mesh);
+void mesh_clear(Mesh* mesh);
 
+Quad* mesh_new_quad(Mesh* mesh);
 void mesh_add_quad(Mesh* mesh, Quad* quad);
+void mesh_add_quads(Mesh* mesh, Quad* quads, int count);
 void mesh_calc_normals(Mesh* mesh);
 
+void mesh_set_arena(Mesh* mesh, GPUArena* arena, float* origin);
+
 void mesh_buffer(Mesh* mesh, char mode);
+void mesh_buffer_range(Mesh* mesh, int first);
+
+GLuint mesh_vbo(Mesh* mesh);
+int mesh_first_quad(Mesh* mesh);
 
 #endif // MESH_H
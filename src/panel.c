@@ -37,11 +37,21 @@ Panel* panel_init(Panel* d, void* owner, void (*drawCallback)(void*), PanelManag
     panel->drawCallback = drawCallback;
     panel->manager = manager;
 
+    panel->dirty = 1;
+
     linked_list_init(&panel->actionRegions);
 
     glGenBuffers(1, &panel->vbo);
     glGenTextures(1, &panel->tex);
 
+    // Storage is allocated once; redraws only replace the pixels
+    if (panel->drawCallback) {
+        glBindTexture(GL_TEXTURE_2D, panel->tex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, panel->width, panel->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+
     float vertex_data[] =  {
         panel->position[0], panel->position[1], -0.5, 0, 0,
         panel->position[0], panel->position[1] + panel->height, -0.5, 0, 1,
@@ -121,14 +131,23 @@ void panel_translate(Panel* panel, int x, int y) {
     panel_set_position(panel, tx, ty);
 }
 
+void panel_mark_dirty(Panel* panel) {
+    panel->dirty = 1;
+}
+
 void panel_texture(Panel* panel) {
     glBindTexture(GL_TEXTURE_2D, panel->tex);
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    if (!panel->dirty)
+        return;
+
+    panel->drawCallback(panel->owner);
+    cairo_surface_flush(panel->surface);
 
     unsigned char* pixels = cairo_image_surface_get_data(panel->surface);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, panel->width, panel->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, panel->width, panel->height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    panel->dirty = 0;
 }
 
 /* PanelManager */
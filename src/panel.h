@@ -47,6 +47,9 @@ typedef struct Panel {
     unsigned int width;
     unsigned int height;
 
+    // Set when the owner's state changes; only dirty panels are redrawn
+    char dirty;
+
     LinkedList actionRegions;
 } Panel;
 
@@ -59,6 +62,7 @@ void panel_action(Panel* panel, char action, unsigned int x, unsigned int y);
 void panel_set_position(Panel* panel, int x, int y);
 void panel_translate(Panel* panel, int x, int y);
 
+void panel_mark_dirty(Panel* panel);
 void panel_texture(Panel* panel);
 
 /* PanelManager */
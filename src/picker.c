@@ -7,13 +7,17 @@ void picker_init(Picker* p, World* world, UndoStack* undoStack) {
     picker->undoStack = undoStack;
 
     box_init(&picker->box);
-    box_mesh(&picker->mesh, &picker->box);
 
     picker->selection.model = NULL;
     picker->selection.rotation = 0;
     picker->selection.present = 0;
 
+    memset(&picker->hit, 0, sizeof(WorldRayHit));
+    picker->hit.face = -1;
+
     picker->dragging = 0;
+    picker->stroking = 0;
+    picker->strokeAxis = -1;
     picker->mode = PICKER_ADJACENT;
     picker->action = PICKER_SET;
 
@@ -21,7 +25,7 @@ void picker_init(Picker* p, World* world, UndoStack* undoStack) {
 }
 
 void picker_destroy(Picker* picker) {
-    mesh_destroy(&picker->mesh);
+    picker_drop_model(picker);
 }
 
 void picker_update(Picker* picker, Camera* camera, float mouseX, float mouseY) {
@@ -42,44 +46,28 @@ void picker_update(Picker* picker, Camera* camera, float mouseX, float mouseY) {
     vec4_transform(ray, camera->mat_view, ray);
 
     vec3_normalize(ray, ray);
-    vec3_scale(ray, ray, 0.2);
-
-    float ray_point[3];
-    memcpy(ray_point, camera->position, 3*sizeof(float));
 
-    Block* block;
-    int block_location[3];
-    int block_location_adjacent[3];
-    for (int i = 0; i < 1000; ++i) {
-        memcpy(block_location_adjacent, block_location, 3*sizeof(int));
-        block_location[0] = floor(ray_point[0]);
-        block_location[1] = floor(ray_point[1]);
-        block_location[2] = floor(ray_point[2]);
+    WorldRayHit hit;
+    int cell[3];
+    int* location = NULL;
 
-        block = world_get_block(picker->world, block_location);
-
-        if (block_location[1] < 0)
-            break;
+    if (picker->stroking && picker->strokeAxis >= 0) {
+        location = picker_stroke_cell(picker, camera->position, ray, cell);
+    } else if (world_cast_ray(picker->world, camera->position, ray, PICKER_RAY_LENGTH, &hit)) {
+        // The ground can only be built onto, never picked itself
+        location = picker->mode == PICKER_ONTO && hit.position[1] >= 0 ? hit.position : hit.adjacent;
+        picker->hit = hit;
+    }
 
-        if (block && block_is_active(block))
-            break;
+    if (location) {
+        char moved = memcmp(picker->positionEnd, location, 3*sizeof(int)) != 0;
 
-        vec3_add(ray_point, ray_point, ray);
-    }
+        if (!picker->dragging || picker->stroking)
+            memcpy(picker->positionStart, location, 3*sizeof(int));
+        memcpy(picker->positionEnd, location, 3*sizeof(int));
 
-    if (block || block_location[1] == -1) {
-        if (!picker->dragging) {
-            if (picker->mode == PICKER_ONTO && block_location[1] >= 0) {
-                memcpy(picker->positionStart, block_location, 3*sizeof(int));
-            } else {
-                memcpy(picker->positionStart, block_location_adjacent, 3*sizeof(int));
-            }
-        }
-        if (picker->mode == PICKER_ONTO && block_location[1] >= 0) {
-            memcpy(picker->positionEnd, block_location, 3*sizeof(int));
-        } else {
-            memcpy(picker->positionEnd, block_location_adjacent, 3*sizeof(int));
-        }
+        if (picker->stroking && moved)
+            picker_paint(picker);
     }
 
     picker->box.position[0] = MIN(picker->positionStart[0], picker->positionEnd[0]);
@@ -88,19 +76,40 @@ void picker_update(Picker* picker, Camera* camera, float mouseX, float mouseY) {
     picker->box.width = abs(picker->positionEnd[0] - picker->positionStart[0]) + 1;
     picker->box.height = abs(picker->positionEnd[1] - picker->positionStart[1]) + 1;
     picker->box.length = abs(picker->positionEnd[2] - picker->positionStart[2]) + 1;
-
-    mesh_destroy(&picker->mesh);
-    box_mesh(&picker->mesh, &picker->box);
 }
 
 void picker_press(Picker* picker, char modifier1, char modifier2) {
     picker->dragging = 1;
+
+    // Shift-dragging the pencil or eraser paints freehand as one undo step
+    if (modifier1 && (picker->action == PICKER_SET || picker->action == PICKER_CLEAR)) {
+        picker->stroking = 1;
+        picker->strokeAxis = -1;
+
+        // Without a face to follow, for instance from inside a block, the
+        // stroke goes on picking blocks as usual
+        for (int a = 0; a < 3 && picker->hit.face >= 0; a++) {
+            if (picker->hit.position[a] != picker->hit.adjacent[a]) {
+                picker->strokeAxis = a;
+                picker->strokePlane = MAX(picker->hit.position[a], picker->hit.adjacent[a]);
+                picker->strokeLayer = picker->positionEnd[a];
+            }
+        }
+
+        undo_stack_begin_stroke(picker->undoStack);
+        picker_paint(picker);
+    }
 }
 
 void picker_release(Picker* picker, char modifier1, char modifier2) {
     picker->dragging = 0;
 
-    picker_act(picker, modifier1, modifier2);
+    if (picker->stroking) {
+        picker->stroking = 0;
+        undo_stack_end_stroke(picker->undoStack);
+    } else {
+        picker_act(picker, modifier1, modifier2);
+    }
 
     memcpy(picker->positionStart, picker->positionEnd, 3*sizeof(int));
 
@@ -110,15 +119,11 @@ void picker_release(Picker* picker, char modifier1, char modifier2) {
     picker->box.width = 1;
     picker->box.height = 1;
     picker->box.length = 1;
-
-    mesh_destroy(&picker->mesh);
-    box_mesh(&picker->mesh, &picker->box);
 }
 
 void picker_act(Picker* picker, char modifier1, char modifier2) {
     if (picker->action == PICKER_SELECT) {
         picker->selection.box = modifier1 ? picker_merge_selections(&picker->selection.box, &picker->box) : picker->box;
-        box_mesh(&picker->selection.mesh, &picker->selection.box);
         picker->selection.present = 1;
         picker->selection.rotation = 0;
     } else if (picker->action == PICKER_STAMP) {
@@ -147,6 +152,41 @@ void picker_act(Picker* picker, char modifier1, char modifier2) {
     }
 }
 
+void picker_paint(Picker* picker) {
+    Box cell;
+    box_init(&cell);
+
+    cell.position[0] = picker->positionEnd[0];
+    cell.position[1] = picker->positionEnd[1];
+    cell.position[2] = picker->positionEnd[2];
+
+    if (picker->action == PICKER_SET) {
+        WorldSetRegionCommand* setRegionCommand = world_set_region_command_init(picker->world, &cell, picker->color);
+        undo_stack_push(picker->undoStack, &setRegionCommand->command);
+    } else {
+        WorldClearRegionCommand* clearRegionCommand = world_clear_region_command_init(picker->world, &cell);
+        undo_stack_push(picker->undoStack, &clearRegionCommand->command);
+    }
+}
+
+int* picker_stroke_cell(Picker* picker, float* origin, float* direction, int* cell) {
+    int a = picker->strokeAxis;
+
+    if (direction[a] == 0)
+        return NULL;
+
+    // Where the ray crosses the plane of the face the stroke started on
+    float t = (picker->strokePlane - origin[a]) / direction[a];
+    if (t <= 0 || t > PICKER_RAY_LENGTH)
+        return NULL;
+
+    for (int b = 0; b < 3; b++)
+        cell[b] = floor(origin[b] + direction[b] * t);
+    cell[a] = picker->strokeLayer;
+
+    return cell;
+}
+
 Box picker_merge_selections(Box* selectionA, Box* selectionB) {
     Box merged;
     box_init(&merged);
@@ -181,16 +221,23 @@ Box picker_merge_selections(Box* selectionA, Box* selectionB) {
 void picker_set_action(Picker* picker, char action) {
     picker->action = action;
 
+    picker_drop_model(picker);
+
     if (action == PICKER_STAMP || action == PICKER_MOVE) {
         picker->selection.model = action == PICKER_STAMP
                                   ? world_copy_chunk(picker->world, &picker->selection.box)
                                   : world_cut_chunk(picker->world, &picker->selection.box);
-        chunk_mesh(picker->selection.model);
+        chunk_mesh(picker->selection.model, NULL);
         picker->mode = PICKER_ADJACENT;
     }  else {
         picker->selection.present = 0;
-        if (picker->selection.model) {
-            picker->selection.model = NULL;
-        }
+    }
+}
+
+void picker_drop_model(Picker* picker) {
+    if (picker->selection.model) {
+        chunk_destroy(picker->selection.model);
+        free(picker->selection.model);
+        picker->selection.model = NULL;
     }
 }
@@ -21,9 +21,12 @@
 #define PICKER_STAMP       7
 #define PICKER_MOVE        8
 
+#define PICKER_RAY_LENGTH  200
+
 typedef struct {
     Box box;
-    Mesh mesh;
+    // The clipboard. Stamp and move commands only read it while recording
+    // their first redo, so it is not counted against the undo budget
     Chunk* model;
     char rotation;
     char present;
@@ -36,10 +39,19 @@ typedef struct {
     int positionStart[3];
     int positionEnd[3];
     Box box;
-    Mesh mesh;
     Selection selection;
 
+    // The last block face picked
+    WorldRayHit hit;
+
     char dragging;
+    // Set while a pencil or eraser drag paints every cell it passes over.
+    // A stroke stays in the layer of cells on the face it started on, so
+    // blocks it has just painted are never built onto in turn
+    char stroking;
+    int strokeAxis;
+    int strokePlane;
+    int strokeLayer;
     char mode;
     char action;
 
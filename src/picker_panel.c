@@ -79,6 +79,10 @@ PickerPanel* picker_panel_init(PickerPanel* pp, PanelManager* panelManager, Pick
 
     pickerPanel->picker->color = 0;
 
+    pickerPanel->drawnColor = 0;
+    pickerPanel->drawnAction = 0;
+    pickerPanel->drawnSelection = 0;
+
     picker_panel_add_titlebar_action_region(pickerPanel);
     picker_panel_add_bluebar_action_region(pickerPanel);
     picker_panel_add_palette_action_region(pickerPanel);
@@ -109,6 +113,17 @@ void picker_panel_destroy(PickerPanel* pickerPanel) {
     panel_destroy(&pickerPanel->panel);
 }
 
+void picker_panel_update(PickerPanel* pickerPanel) {
+    // The picker changes from the keyboard and the eyedropper as well as
+    // from this panel, so compare against what was last drawn
+    Picker* picker = pickerPanel->picker;
+
+    if (picker->color != pickerPanel->drawnColor ||
+        picker->action != pickerPanel->drawnAction ||
+        picker->selection.present != pickerPanel->drawnSelection)
+        panel_mark_dirty(&pickerPanel->panel);
+}
+
 void picker_panel_draw_background(PickerPanel* pickerPanel) {
     cairo_set_source_surface(pickerPanel->panel.cr, pickerPanel->background_surface, 0, 0);
     cairo_paint(pickerPanel->panel.cr);
@@ -268,6 +283,10 @@ void picker_panel_draw_buttons(PickerPanel* pickerPanel) {
 void picker_panel_draw(void* pickerPanelPtr) {
     PickerPanel* pickerPanel = (PickerPanel*)pickerPanelPtr;
 
+    pickerPanel->drawnColor = pickerPanel->picker->color;
+    pickerPanel->drawnAction = pickerPanel->picker->action;
+    pickerPanel->drawnSelection = pickerPanel->picker->selection.present;
+
     picker_panel_draw_background(pickerPanel);
     picker_panel_draw_bluebar(pickerPanel);
     picker_panel_draw_palette(pickerPanel);
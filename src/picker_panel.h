@@ -22,9 +22,15 @@ typedef struct {
     cairo_surface_t* move_button_surface_selected;
 
     Picker* picker;
+
+    // Picker state the panel texture currently shows
+    uint16_t drawnColor;
+    char drawnAction;
+    char drawnSelection;
 } PickerPanel;
 
 PickerPanel* picker_panel_init(PickerPanel* td, PanelManager* panelManager, Picker* picker);
 void picker_panel_destroy(PickerPanel* pickerPanel);
+void picker_panel_update(PickerPanel* pickerPanel);
 
 #endif // PICKER_PANEL_H
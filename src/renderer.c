@@ -1,27 +1,46 @@
 #include "renderer.h"
 #include "internal/renderer.h"
 
-void render_mesh(void* ptr, void* rendererPtr) {
-    Mesh* mesh = (Mesh*)ptr;
+int compare_batches(const void* batchAPtr, const void* batchBPtr) {
+    RendererBatch* batchA = (RendererBatch*)batchAPtr;
+    RendererBatch* batchB = (RendererBatch*)batchBPtr;
+
+    if (batchA->page != batchB->page)
+        return batchA->page - batchB->page;
+
+    return batchA->first - batchB->first;
+}
+
+void count_world_chunk(void* worldChunkPtr, void* rendererPtr) {
+    WorldChunk* worldChunk = (WorldChunk*)worldChunkPtr;
     Renderer* renderer = (Renderer*)rendererPtr;
 
-    float color[3];
-    block_color_rgb(mesh->color, color);
-    renderer_3D_update_color(renderer, color[0], color[1], color[2]);
-    renderer_render_mesh(renderer, mesh, MESH_FILL);
+    if (!worldChunk->chunk->mesh.quads.size)
+        return;
+
+    Box box;
+    renderer_chunk_box(&box, worldChunk);
+
+    renderer->stats.chunksConsidered++;
+
+    if (frustum_intersects_box(&renderer->frustum, &box))
+        renderer->stats.chunksInFrustum++;
 }
 
 void render_world_chunk(void* worldChunkPtr, void* rendererPtr) {
     WorldChunk* worldChunk = (WorldChunk*)worldChunkPtr;
     Renderer* renderer = (Renderer*)rendererPtr;
-    float position[3] = {
-        worldChunk->id.x * WORLD_CHUNK_LENGTH,
-        worldChunk->id.y * WORLD_CHUNK_LENGTH,
-        worldChunk->id.z * WORLD_CHUNK_LENGTH
-    };
 
-    if (worldChunk->chunk->meshes.size)
-        renderer_render_chunk(renderer, worldChunk->chunk, position);
+    if (!worldChunk->chunk->mesh.quads.size)
+        return;
+
+    Box box;
+    renderer_chunk_box(&box, worldChunk);
+
+    if (frustum_intersects_box(&renderer->frustum, &box)) {
+        renderer->stats.chunksDrawn++;
+        renderer_render_chunk_faces(renderer, worldChunk->chunk, box.position);
+    }
 }
 
 void render_panel(void* panelPtr, void* rendererPtr) {
@@ -31,6 +50,10 @@ void render_panel(void* panelPtr, void* rendererPtr) {
 }
 
 void renderer_render_panel(Renderer* renderer, Panel* panel) {
+    // Panels without a draw callback only hold a place on screen
+    if (!panel->drawCallback)
+        return;
+
     renderer_2D_use(renderer);
     glBindBuffer(GL_ARRAY_BUFFER, panel->vbo);
 
@@ -39,10 +62,10 @@ void renderer_render_panel(Renderer* renderer, Panel* panel) {
     glEnableVertexAttribArray(renderer->shaderProgram2D.attrib_texcoord);
     glVertexAttribPointer(renderer->shaderProgram2D.attrib_texcoord, 2, GL_FLOAT, GL_FALSE, 5*sizeof(float), (void*)(3*sizeof(float)));
 
-    panel->drawCallback(panel->owner);
     panel_texture(panel);
 
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    renderer->stats.drawCalls++;
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
@@ -50,8 +73,27 @@ void renderer_render_panel(Renderer* renderer, Panel* panel) {
 Renderer* renderer_init(Renderer* r) {
     Renderer* renderer = r ? r : NEW(Renderer, 1);
 
+    memset(&renderer->stats, 0, sizeof(RendererStats));
+    renderer->occlusionCulling = 1;
+
+    memset(&renderer->fillIndices, 0, sizeof(QuadIndexBuffer));
+    memset(&renderer->lineIndices, 0, sizeof(QuadIndexBuffer));
+
+    renderer->batches = NULL;
+    renderer->batchCount = 0;
+    renderer->batchCapacity = 0;
+
     shader_program_3D_init(&renderer->shaderProgram3D);
 
+    memset(&renderer->frame, 0, sizeof(RendererFrame));
+    renderer->frameChanged = 1;
+
+    glGenBuffers(1, &renderer->frameBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, renderer->frameBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(RendererFrame), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, SHADER_3D_FRAME_BINDING, renderer->frameBuffer);
+
     float mat4[16];
     renderer_3D_update_model(renderer, mat4_identity(mat4));
     renderer_3D_update_ambient(renderer, 0.4);
@@ -61,6 +103,15 @@ Renderer* renderer_init(Renderer* r) {
 
     shader_program_2D_init(&renderer->shaderProgram2D);
 
+    glyph_atlas_init(&renderer->glyphAtlas, "Cantarell Regular", 12);
+    glGenBuffers(1, &renderer->textVbo);
+    renderer->textVertices = NULL;
+    renderer->textQuads = 0;
+    renderer->textCapacity = 0;
+
+    Box unitBox;
+    box_mesh(&renderer->boxMesh, box_init(&unitBox));
+
     glActiveTexture(GL_TEXTURE0);
     renderer_2D_update_sampler(renderer, 0);
 
@@ -77,12 +128,33 @@ Renderer* renderer_init(Renderer* r) {
 }
 
 void renderer_destroy(Renderer* renderer) {
+    free(renderer->batches);
+
+    free(renderer->textVertices);
+    glDeleteBuffers(1, &renderer->textVbo);
+    glyph_atlas_destroy(&renderer->glyphAtlas);
+
+    mesh_destroy(&renderer->boxMesh);
+
+    glDeleteBuffers(1, &renderer->lineIndices.ebo);
+    glDeleteBuffers(1, &renderer->fillIndices.ebo);
+    glDeleteBuffers(1, &renderer->frameBuffer);
+
     shader_program_2D_destroy(&renderer->shaderProgram2D);
     shader_program_3D_destroy(&renderer->shaderProgram3D);
 }
 
 void renderer_clear(Renderer* renderer) {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    memset(&renderer->stats, 0, sizeof(RendererStats));
+    shader_reset_state_changes();
+
+    renderer_3D_upload_frame(renderer);
+}
+
+void renderer_finish(Renderer* renderer) {
+    renderer->stats.stateChanges = shader_state_changes();
 }
 
 void renderer_resize(Renderer* renderer, int width, int height, Camera* camera) {
@@ -106,13 +178,13 @@ void renderer_3D_update_model(Renderer* renderer, float* mat4) {
 }
 
 void renderer_3D_update_camera(Renderer* renderer, float* mat4) {
-    shader_program_3D_use(&renderer->shaderProgram3D);
-    shader_program_3D_update_camera(&renderer->shaderProgram3D, mat4);
+    memcpy(renderer->frame.camera, mat4, sizeof(renderer->frame.camera));
+    renderer->frameChanged = 1;
 }
 
 void renderer_3D_update_projection(Renderer* renderer, float* mat4) {
-    shader_program_3D_use(&renderer->shaderProgram3D);
-    shader_program_3D_update_projection(&renderer->shaderProgram3D, mat4);
+    memcpy(renderer->frame.projection, mat4, sizeof(renderer->frame.projection));
+    renderer->frameChanged = 1;
 }
 
 void renderer_3D_update_color(Renderer* renderer, float r, float g, float b) {
@@ -121,13 +193,25 @@ void renderer_3D_update_color(Renderer* renderer, float r, float g, float b) {
 }
 
 void renderer_3D_update_ambient(Renderer* renderer, float a) {
-    shader_program_3D_use(&renderer->shaderProgram3D);
-    shader_program_3D_update_ambient(&renderer->shaderProgram3D, a);
+    renderer->frame.ambient = a;
+    renderer->frameChanged = 1;
 }
 
 void renderer_3D_update_sun_position(Renderer* renderer, float* position) {
-    shader_program_3D_use(&renderer->shaderProgram3D);
-    shader_program_3D_update_sun_position(&renderer->shaderProgram3D, position);
+    memcpy(renderer->frame.sunPosition, position, sizeof(renderer->frame.sunPosition));
+    renderer->frameChanged = 1;
+}
+
+void renderer_3D_upload_frame(Renderer* renderer) {
+    if (!renderer->frameChanged)
+        return;
+
+    // One upload per frame at most, however many of the values changed
+    glBindBuffer(GL_UNIFORM_BUFFER, renderer->frameBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(RendererFrame), &renderer->frame);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    renderer->frameChanged = 0;
 }
 
 void renderer_apply_camera(Renderer* renderer, Camera* camera) {
@@ -159,23 +243,232 @@ void renderer_2D_use(Renderer* renderer) {
     shader_program_2D_use(&renderer->shaderProgram2D);
 }
 
+void renderer_chunk_box(Box* box, WorldChunk* worldChunk) {
+    box_init(box);
+
+    box->position[0] = worldChunk->id.x * WORLD_CHUNK_LENGTH;
+    box->position[1] = worldChunk->id.y * WORLD_CHUNK_LENGTH;
+    box->position[2] = worldChunk->id.z * WORLD_CHUNK_LENGTH;
+
+    box->width = worldChunk->chunk->width;
+    box->height = worldChunk->chunk->height;
+    box->length = worldChunk->chunk->length;
+}
+
+void renderer_bind_quad_indices(Renderer* renderer, char mode, int quads) {
+    QuadIndexBuffer* indices = mode == MESH_FILL ? &renderer->fillIndices : &renderer->lineIndices;
+
+    if (!indices->ebo)
+        glGenBuffers(1, &indices->ebo);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices->ebo);
+
+    if (quads <= indices->quads)
+        return;
+
+    // Fill meshes are drawn as a triangle list and line meshes as line segments
+    static const int fill_order[] = { 0, 1, 2, 2, 1, 3 };
+    static const int line_order[] = { 0, 1, 1, 3, 3, 2, 2, 0 };
+
+    const int* order = mode == MESH_FILL ? fill_order : line_order;
+    int elements_per_quad = mode == MESH_FILL ? MESH_FILL_ELEMENTS_PER_QUAD : MESH_LINE_ELEMENTS_PER_QUAD;
+
+    indices->quads = MAX(quads, indices->quads * 2);
+
+    GLuint* elements = NEW(GLuint, indices->quads * elements_per_quad);
+    for (int q = 0; q < indices->quads; q++) {
+        for (int e = 0; e < elements_per_quad; e++)
+            elements[q*elements_per_quad+e] = q*4 + order[e];
+    }
+
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices->quads * elements_per_quad * sizeof(GLuint), elements, GL_STATIC_DRAW);
+
+    free(elements);
+}
+
 void renderer_render_chunk(Renderer* renderer, Chunk* chunk, float* position) {
+    MeshRange range;
+    range.first = 0;
+    range.count = chunk->mesh.quads.size;
+
     renderer_3D_update_world_position(renderer, position);
-    linked_list_foreach(&chunk->meshes, render_mesh, renderer);
+
+    // Packed vertices carry their own color
+    if (chunk->mesh.format == MESH_FORMAT_FLOAT)
+        shader_program_3D_enable_color_array(&renderer->shaderProgram3D, GL_TRUE);
+    renderer_render_mesh_ranges(renderer, &chunk->mesh, MESH_FILL, &range, 1);
+    shader_program_3D_enable_color_array(&renderer->shaderProgram3D, GL_FALSE);
+}
+
+void renderer_render_chunk_faces(Renderer* renderer, Chunk* chunk, float* position) {
+    MeshRange ranges[6];
+
+    // Only draw the face directions that can point toward the camera
+    float eye[3] = {
+        renderer->eye[0] - position[0],
+        renderer->eye[1] - position[1],
+        renderer->eye[2] - position[2]
+    };
+
+    int count = chunk_visible_ranges(chunk, eye, ranges);
+
+    // Fewer, slightly longer ranges are cheaper than skipping a few quads
+    int merged = 0;
+    for (int r = 0; r < count; r++) {
+        if (merged && ranges[r].first - (ranges[merged-1].first + ranges[merged-1].count) <= RENDERER_BATCH_GAP_QUADS) {
+            ranges[merged-1].count = ranges[r].first + ranges[r].count - ranges[merged-1].first;
+        } else {
+            ranges[merged++] = ranges[r];
+        }
+    }
+    count = merged;
+
+    int drawn = 0;
+    for (int r = 0; r < count; r++) {
+        drawn += ranges[r].count;
+    }
+    renderer->stats.quadsFacingAway += chunk->mesh.quads.size - drawn;
+
+    if (!count)
+        return;
+
+    // Arena meshes are drawn together once the whole world has been walked
+    if (chunk->mesh.block) {
+        renderer_queue_mesh_ranges(renderer, &chunk->mesh, ranges, count);
+        return;
+    }
+
+    renderer_3D_update_world_position(renderer, position);
+
+    if (chunk->mesh.format == MESH_FORMAT_FLOAT)
+        shader_program_3D_enable_color_array(&renderer->shaderProgram3D, GL_TRUE);
+    renderer_render_mesh_ranges(renderer, &chunk->mesh, MESH_FILL, ranges, count);
+    shader_program_3D_enable_color_array(&renderer->shaderProgram3D, GL_FALSE);
+}
+
+void renderer_queue_mesh_ranges(Renderer* renderer, Mesh* mesh, MeshRange* ranges, int count) {
+    if (renderer->batchCount + count > renderer->batchCapacity) {
+        renderer->batchCapacity = MAX(renderer->batchCount + count, renderer->batchCapacity * 2);
+        renderer->batches = realloc(renderer->batches, renderer->batchCapacity * sizeof(RendererBatch));
+    }
+
+    for (int r = 0; r < count; r++) {
+        RendererBatch* batch = &renderer->batches[renderer->batchCount++];
+        batch->page = mesh->block->page;
+        batch->first = mesh->block->first + ranges[r].first;
+        batch->count = ranges[r].count;
+    }
+}
+
+void renderer_render_batches(Renderer* renderer, GPUArena* arena) {
+    if (!renderer->batchCount)
+        return;
+
+    // Each vertex finds its chunk origin through its slot, so a page needs no
+    // per-chunk state and ranges that touch in the page become one draw
+    qsort(renderer->batches, renderer->batchCount, sizeof(RendererBatch), compare_batches);
+
+    renderer_3D_use(renderer);
+    shader_program_3D_update_use_packed_vertex(&renderer->shaderProgram3D, GL_TRUE);
+    shader_program_3D_update_use_chunk_slot(&renderer->shaderProgram3D, GL_TRUE);
+
+    glDisableVertexAttribArray(renderer->shaderProgram3D.attrib_position);
+    glDisableVertexAttribArray(renderer->shaderProgram3D.attrib_normal);
+    glEnableVertexAttribArray(renderer->shaderProgram3D.attrib_packed_vertex);
+    glEnableVertexAttribArray(renderer->shaderProgram3D.attrib_chunk_slot);
+
+    int quads = 0;
+    for (int b = 0; b < renderer->batchCount; b++) {
+        quads = MAX(quads, renderer->batches[b].first + renderer->batches[b].count);
+    }
+    renderer_bind_quad_indices(renderer, MESH_FILL, quads);
+
+    int b = 0;
+    while (b < renderer->batchCount) {
+        GPUArenaPage* page = &arena->pages[renderer->batches[b].page];
+
+        glBindBuffer(GL_ARRAY_BUFFER, page->vbo);
+        glVertexAttribIPointer(renderer->shaderProgram3D.attrib_packed_vertex, 1, GL_UNSIGNED_INT, arena->vertexSize, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, page->slots);
+        glVertexAttribIPointer(renderer->shaderProgram3D.attrib_chunk_slot, 1, GL_UNSIGNED_SHORT, sizeof(GLushort), 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, SHADER_3D_CHUNK_ORIGINS_BINDING, page->origins);
+
+        int pageIndex = renderer->batches[b].page;
+        while (b < renderer->batchCount && renderer->batches[b].page == pageIndex) {
+            int first = renderer->batches[b].first;
+            int last = first + renderer->batches[b].count;
+
+            for (b++; b < renderer->batchCount && renderer->batches[b].page == pageIndex && renderer->batches[b].first == last; b++) {
+                last += renderer->batches[b].count;
+            }
+
+            glDrawElements(GL_TRIANGLES,
+                           (last - first) * MESH_FILL_ELEMENTS_PER_QUAD,
+                           GL_UNSIGNED_INT,
+                           (void*)(intptr_t)(first * MESH_FILL_ELEMENTS_PER_QUAD * sizeof(GLuint)));
+            renderer->stats.drawCalls++;
+            renderer->stats.quadsDrawn += last - first;
+        }
+    }
+
+    glDisableVertexAttribArray(renderer->shaderProgram3D.attrib_chunk_slot);
+    glDisableVertexAttribArray(renderer->shaderProgram3D.attrib_packed_vertex);
+    shader_program_3D_update_use_chunk_slot(&renderer->shaderProgram3D, GL_FALSE);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    renderer->batchCount = 0;
 }
 
 void renderer_render_mesh(Renderer* renderer, Mesh* mesh, char mode) {
+    MeshRange range;
+    range.first = 0;
+    range.count = mesh->quads.size;
+
+    renderer_render_mesh_ranges(renderer, mesh, mode, &range, 1);
+}
+
+void renderer_render_mesh_ranges(Renderer* renderer, Mesh* mesh, char mode, MeshRange* ranges, int count) {
     renderer_3D_use(renderer);
-    glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ebo);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh_vbo(mesh));
+
+    if (mesh->format == MESH_FORMAT_PACKED) {
+        glDisableVertexAttribArray(renderer->shaderProgram3D.attrib_position);
+        glDisableVertexAttribArray(renderer->shaderProgram3D.attrib_normal);
+        glEnableVertexAttribArray(renderer->shaderProgram3D.attrib_packed_vertex);
+        glVertexAttribIPointer(renderer->shaderProgram3D.attrib_packed_vertex, 1, GL_UNSIGNED_INT, sizeof(GLuint), 0);
+        shader_program_3D_update_use_packed_vertex(&renderer->shaderProgram3D, GL_TRUE);
+    } else {
+        glEnableVertexAttribArray(renderer->shaderProgram3D.attrib_position);
+        glVertexAttribPointer(renderer->shaderProgram3D.attrib_position, 3, GL_FLOAT, GL_FALSE, 9*sizeof(float), 0);
+        glEnableVertexAttribArray(renderer->shaderProgram3D.attrib_normal);
+        glVertexAttribPointer(renderer->shaderProgram3D.attrib_normal, 3, GL_FLOAT, GL_FALSE, 9*sizeof(float), (void*)(3*sizeof(float)));
+        glVertexAttribPointer(renderer->shaderProgram3D.attrib_color, 3, GL_FLOAT, GL_FALSE, 9*sizeof(float), (void*)(6*sizeof(float)));
+        shader_program_3D_update_use_packed_vertex(&renderer->shaderProgram3D, GL_FALSE);
+    }
+
+    int elements_per_quad = mode == MESH_FILL ? MESH_FILL_ELEMENTS_PER_QUAD : MESH_LINE_ELEMENTS_PER_QUAD;
 
-    glEnableVertexAttribArray(renderer->shaderProgram3D.attrib_position);
-    glVertexAttribPointer(renderer->shaderProgram3D.attrib_position, 3, GL_FLOAT, GL_FALSE, 6*sizeof(float), 0);
-    glEnableVertexAttribArray(renderer->shaderProgram3D.attrib_normal);
-    glVertexAttribPointer(renderer->shaderProgram3D.attrib_normal, 3, GL_FLOAT, GL_FALSE, 6*sizeof(float), (void*)(3*sizeof(float)));
+    // Meshes in the arena start partway into a shared buffer
+    int first_quad = mesh_first_quad(mesh);
 
-    for (int q=0; q<mesh->quads.size; q++)
-        glDrawElements(mode == MESH_FILL ? GL_TRIANGLE_STRIP : GL_LINE_LOOP, 4, GL_UNSIGNED_SHORT, (GLvoid*) (4*q*sizeof(GLushort)));
+    int quads = 0;
+    for (int r = 0; r < count; r++) {
+        quads = MAX(quads, first_quad + ranges[r].first + ranges[r].count);
+    }
+    renderer_bind_quad_indices(renderer, mode, quads);
+
+    for (int r = 0; r < count; r++) {
+        glDrawElements(mode == MESH_FILL ? GL_TRIANGLES : GL_LINES,
+                       ranges[r].count * elements_per_quad,
+                       GL_UNSIGNED_INT,
+                       (void*)(intptr_t)((first_quad + ranges[r].first) * elements_per_quad * sizeof(GLuint)));
+        renderer->stats.drawCalls++;
+        renderer->stats.quadsDrawn += ranges[r].count;
+    }
+
+    glDisableVertexAttribArray(renderer->shaderProgram3D.attrib_packed_vertex);
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -195,7 +488,29 @@ void renderer_render_ground(Renderer* renderer, Ground* ground, Camera* camera)
 void renderer_render_world(Renderer* renderer, World* world, Camera* camera) {
     renderer_render_ground(renderer, &world->ground, camera);
 
-    linked_list_foreach(&world->chunks, render_world_chunk, renderer);
+    camera_frustum(&renderer->frustum, camera);
+    memcpy(renderer->eye, camera->position, sizeof(renderer->eye));
+    linked_list_foreach(&world->chunks, count_world_chunk, renderer);
+
+    if (renderer->occlusionCulling) {
+        LinkedList visibleList;
+        world_visible_list(world, &visibleList, camera, &renderer->frustum);
+        linked_list_foreach(&visibleList, render_world_chunk, renderer);
+        linked_list_destroy(&visibleList, NULL);
+    } else {
+        linked_list_foreach(&world->chunks, render_world_chunk, renderer);
+    }
+
+    renderer_render_batches(renderer, &world->arena);
+}
+
+void renderer_render_box(Renderer* renderer, Box* box) {
+    float mat[16];
+    float scale[] = { box->width, box->height, box->length };
+
+    renderer_3D_update_model(renderer, mat4_scale(mat, NULL, scale));
+    renderer_3D_update_world_position(renderer, box->position);
+    renderer_render_mesh(renderer, &renderer->boxMesh, MESH_LINE);
 }
 
 void renderer_render_picker(Renderer* renderer, Picker* picker) {
@@ -203,9 +518,8 @@ void renderer_render_picker(Renderer* renderer, Picker* picker) {
     float vec[3];
 
     if (picker->selection.present) {
-        renderer_3D_update_world_position(renderer, picker->selection.box.position);
         renderer_3D_update_color(renderer, 0,255,255);
-        renderer_render_mesh(renderer, &picker->selection.mesh, MESH_LINE);
+        renderer_render_box(renderer, &picker->selection.box);
     }
 
     if (picker->selection.model) {
@@ -238,14 +552,76 @@ void renderer_render_picker(Renderer* renderer, Picker* picker) {
         renderer_render_chunk(renderer, picker->selection.model, picker->box.position);
     }
 
-    mat4_identity(mat);
-    renderer_3D_update_model(renderer, mat);
-
-    renderer_3D_update_world_position(renderer, picker->box.position);
     renderer_3D_update_color(renderer, 255,255,0);
-    renderer_render_mesh(renderer, &picker->mesh, MESH_LINE);
+    renderer_render_box(renderer, &picker->box);
+
+    renderer_3D_update_model(renderer, mat4_identity(mat));
 }
 
 void renderer_render_panels(Renderer* renderer, LinkedList* panels) {
+    // Overlays are all drawn at the same depth, in order, over the scene
+    glDisable(GL_DEPTH_TEST);
     linked_list_foreach(panels, render_panel, renderer);
+    glEnable(GL_DEPTH_TEST);
+}
+
+void renderer_queue_text(Renderer* renderer, float x, float y, const char* text) {
+    GlyphAtlas* atlas = &renderer->glyphAtlas;
+
+    int length = strlen(text);
+    if (renderer->textQuads + length > renderer->textCapacity) {
+        renderer->textCapacity = MAX(renderer->textQuads + length, renderer->textCapacity * 2);
+        renderer->textVertices = realloc(renderer->textVertices, renderer->textCapacity * 4 * 5 * sizeof(float));
+    }
+
+    // Cells start a pixel left of and above the glyph origin
+    float left = x - 1;
+    float top = y - atlas->ascent - 1;
+
+    for (int c = 0; c < length; c++) {
+        Glyph* glyph = glyph_atlas_glyph(atlas, text[c]);
+
+        float right = left + atlas->cellWidth;
+        float bottom = top + atlas->cellHeight;
+
+        float vertex_data[] = {
+            left,  top,    -0.5, glyph->texcoord[0], glyph->texcoord[1],
+            left,  bottom, -0.5, glyph->texcoord[0], glyph->texcoord[3],
+            right, top,    -0.5, glyph->texcoord[2], glyph->texcoord[1],
+            right, bottom, -0.5, glyph->texcoord[2], glyph->texcoord[3]
+        };
+        memcpy(&renderer->textVertices[renderer->textQuads * 20], vertex_data, sizeof(vertex_data));
+        renderer->textQuads++;
+
+        left += glyph->advance;
+    }
+}
+
+void renderer_render_text(Renderer* renderer) {
+    if (!renderer->textQuads)
+        return;
+
+    renderer_2D_use(renderer);
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->textVbo);
+    glBufferData(GL_ARRAY_BUFFER, renderer->textQuads * 20 * sizeof(float), renderer->textVertices, GL_STREAM_DRAW);
+
+    glEnableVertexAttribArray(renderer->shaderProgram2D.attrib_position);
+    glVertexAttribPointer(renderer->shaderProgram2D.attrib_position, 3, GL_FLOAT, GL_FALSE, 5*sizeof(float), 0);
+    glEnableVertexAttribArray(renderer->shaderProgram2D.attrib_texcoord);
+    glVertexAttribPointer(renderer->shaderProgram2D.attrib_texcoord, 2, GL_FLOAT, GL_FALSE, 5*sizeof(float), (void*)(3*sizeof(float)));
+
+    glBindTexture(GL_TEXTURE_2D, renderer->glyphAtlas.tex);
+    renderer_bind_quad_indices(renderer, MESH_FILL, renderer->textQuads);
+
+    // Glyph cells are wider than their advance, so neighbouring quads overlap
+    // and must blend instead of hiding each other behind transparent texels
+    glDisable(GL_DEPTH_TEST);
+    glDrawElements(GL_TRIANGLES, renderer->textQuads * MESH_FILL_ELEMENTS_PER_QUAD, GL_UNSIGNED_INT, 0);
+    glEnable(GL_DEPTH_TEST);
+    renderer->stats.drawCalls++;
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    renderer->textQuads = 0;
 }
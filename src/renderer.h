@@ -6,23 +6,90 @@
 #include "shader.h"
 #include "matrix.h"
 
+#include "glyph_atlas.h"
 #include "camera.h"
 #include "world.h"
 #include "picker.h"
 
+typedef struct {
+    int chunksConsidered;
+    int chunksInFrustum;
+    int chunksDrawn;
+    int drawCalls;
+    int quadsDrawn;
+    int quadsFacingAway;
+    int stateChanges;
+} RendererStats;
+
+// Visible quads within a quad gap of each other in one chunk are drawn
+// as a single range; the skipped quads face away and get culled by GL
+#define RENDERER_BATCH_GAP_QUADS    64
+
+typedef struct {
+    int page;
+    int first;
+    int count;
+} RendererBatch;
+
+// Quad q always uses vertices 4q..4q+3, so every mesh shares one
+// index buffer per draw mode, grown to fit the largest mesh drawn
+typedef struct {
+    GLuint ebo;
+    int quads;
+} QuadIndexBuffer;
+
+// Per-frame state shared by every 3D draw, laid out as the std140 Frame
+// block in 3D.vert and 3D.frag (the float fills the vec3's padding)
+typedef struct {
+    float camera[16];
+    float projection[16];
+    float sunPosition[3];
+    float ambient;
+} RendererFrame;
+
 typedef struct {
     ShaderProgram3D shaderProgram3D;
     ShaderProgram2D shaderProgram2D;
+
+    Frustum frustum;
+    float eye[3];
+    RendererStats stats;
+
+    RendererFrame frame;
+    GLuint frameBuffer;
+    char frameChanged;
+
+    QuadIndexBuffer fillIndices;
+    QuadIndexBuffer lineIndices;
+
+    RendererBatch* batches;
+    int batchCount;
+    int batchCapacity;
+
+    // Overlay text is queued as textured quads and drawn in one call
+    GlyphAtlas glyphAtlas;
+    GLuint textVbo;
+    float* textVertices;
+    int textQuads;
+    int textCapacity;
+
+    // Picker and selection outlines scale this unit cube by their size
+    Mesh boxMesh;
+
+    char occlusionCulling;
 } Renderer;
 
 Renderer* renderer_init(Renderer* r);
 void renderer_destroy(Renderer* renderer);
 
 void renderer_clear(Renderer* renderer);
+void renderer_finish(Renderer* renderer);
 void renderer_resize(Renderer* renderer, int width, int height, Camera* camera);
 void renderer_apply_camera(Renderer* renderer, Camera* camera);
 void renderer_render_world(Renderer* renderer, World* world, Camera* camera);
 void renderer_render_picker(Renderer* renderer, Picker* picker);
 void renderer_render_panels(Renderer* renderer, LinkedList* panels);
+void renderer_queue_text(Renderer* renderer, float x, float y, const char* text);
+void renderer_render_text(Renderer* renderer);
 
 #endif // RENDERER_H
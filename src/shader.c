@@ -1,4 +1,27 @@
 #include "shader.h"
+#include "internal/shader.h"
+
+// The bound program is context state shared by every shader program
+static GLuint boundProgram = 0;
+static int stateChanges = 0;
+
+int shader_state_changes() {
+    return stateChanges;
+}
+
+void shader_reset_state_changes() {
+    stateChanges = 0;
+}
+
+char shader_sent(void* sent, const void* value, size_t size) {
+    if (!memcmp(sent, value, size))
+        return 1;
+
+    memcpy(sent, value, size);
+    stateChanges++;
+
+    return 0;
+}
 
 GLuint shader_create(const char* path, GLenum shaderType) {
     FILE* file;
@@ -63,52 +86,89 @@ ShaderProgram3D* shader_program_3D_init(ShaderProgram3D* s) {
 
     shaderProgram3D->attrib_position = glGetAttribLocation(shaderProgram3D->shader_prog, "position");
     shaderProgram3D->attrib_normal = glGetAttribLocation(shaderProgram3D->shader_prog, "normal");
+    shaderProgram3D->attrib_color = glGetAttribLocation(shaderProgram3D->shader_prog, "color");
+    shaderProgram3D->attrib_packed_vertex = glGetAttribLocation(shaderProgram3D->shader_prog, "packedVertex");
+    shaderProgram3D->attrib_chunk_slot = glGetAttribLocation(shaderProgram3D->shader_prog, "chunkSlot");
+    shaderProgram3D->unifrm_use_packed_vertex = glGetUniformLocation(shaderProgram3D->shader_prog, "usePackedVertex");
+    shaderProgram3D->unifrm_use_chunk_slot = glGetUniformLocation(shaderProgram3D->shader_prog, "useChunkSlot");
     shaderProgram3D->unifrm_world_position = glGetUniformLocation(shaderProgram3D->shader_prog, "worldPosition");
     shaderProgram3D->unifrm_model = glGetUniformLocation(shaderProgram3D->shader_prog, "model");
-    shaderProgram3D->unifrm_camera = glGetUniformLocation(shaderProgram3D->shader_prog, "camera");
-    shaderProgram3D->unifrm_projection = glGetUniformLocation(shaderProgram3D->shader_prog, "projection");
-    shaderProgram3D->unifrm_ambient = glGetUniformLocation(shaderProgram3D->shader_prog, "ambient");
-    shaderProgram3D->unifrm_color = glGetUniformLocation(shaderProgram3D->shader_prog, "color");
-    shaderProgram3D->unifrm_sun_position = glGetUniformLocation(shaderProgram3D->shader_prog, "sun_position");
+
+    memset(&shaderProgram3D->sent, 0, sizeof(shaderProgram3D->sent));
+
+    GLuint chunkOrigins = glGetUniformBlockIndex(shaderProgram3D->shader_prog, "ChunkOrigins");
+    glUniformBlockBinding(shaderProgram3D->shader_prog, chunkOrigins, SHADER_3D_CHUNK_ORIGINS_BINDING);
+
+    GLuint frame = glGetUniformBlockIndex(shaderProgram3D->shader_prog, "Frame");
+    glUniformBlockBinding(shaderProgram3D->shader_prog, frame, SHADER_3D_FRAME_BINDING);
 
     return shaderProgram3D;
 }
 
 void shader_program_3D_destroy(ShaderProgram3D* shaderProgram3D) {
+    if (boundProgram == shaderProgram3D->shader_prog)
+        boundProgram = 0;
+
     glDeleteProgram(shaderProgram3D->shader_prog);
     glDeleteShader(shaderProgram3D->shader_frag);
     glDeleteShader(shaderProgram3D->shader_vert);
 }
 
 void shader_program_3D_update_world_position(ShaderProgram3D* shaderProgram3D, float* position) {
+    if (shader_sent(shaderProgram3D->sent.worldPosition, position, 3*sizeof(float)))
+        return;
+
     glUniform3f(shaderProgram3D->unifrm_world_position, position[0], position[1], position[2]);
 }
 
 void shader_program_3D_update_model(ShaderProgram3D* shaderProgram3D, float* mat4) {
+    if (shader_sent(shaderProgram3D->sent.model, mat4, 16*sizeof(float)))
+        return;
+
     glUniformMatrix4fv(shaderProgram3D->unifrm_model, 1, GL_FALSE, mat4);
 }
 
-void shader_program_3D_update_camera(ShaderProgram3D* shaderProgram3D, float* mat4) {
-    glUniformMatrix4fv(shaderProgram3D->unifrm_camera, 1, GL_FALSE, mat4);
+void shader_program_3D_update_use_packed_vertex(ShaderProgram3D* shaderProgram3D, GLboolean usePackedVertex) {
+    if (shader_sent(&shaderProgram3D->sent.usePackedVertex, &usePackedVertex, sizeof(GLboolean)))
+        return;
+
+    glUniform1i(shaderProgram3D->unifrm_use_packed_vertex, usePackedVertex);
 }
 
-void shader_program_3D_update_projection(ShaderProgram3D* shaderProgram3D, float* mat4) {
-    glUniformMatrix4fv(shaderProgram3D->unifrm_projection, 1, GL_FALSE, mat4);
+void shader_program_3D_update_use_chunk_slot(ShaderProgram3D* shaderProgram3D, GLboolean useChunkSlot) {
+    if (shader_sent(&shaderProgram3D->sent.useChunkSlot, &useChunkSlot, sizeof(GLboolean)))
+        return;
+
+    glUniform1i(shaderProgram3D->unifrm_use_chunk_slot, useChunkSlot);
 }
 
 void shader_program_3D_update_color(ShaderProgram3D* shaderProgram3D, float r, float g, float b) {
-    glUniform3f(shaderProgram3D->unifrm_color, r/255.0, g/255.0, b/255.0);
-}
+    // Constant color for meshes drawn without the per-vertex color array
+    float color[] = { r/255.0, g/255.0, b/255.0 };
+    if (shader_sent(shaderProgram3D->sent.color, color, sizeof(color)))
+        return;
 
-void shader_program_3D_update_ambient(ShaderProgram3D* shaderProgram3D, float a) {
-    glUniform1f(shaderProgram3D->unifrm_ambient, a);
+    glVertexAttrib3f(shaderProgram3D->attrib_color, color[0], color[1], color[2]);
 }
 
-void shader_program_3D_update_sun_position(ShaderProgram3D* shaderProgram3D, float* position) {
-    glUniform3f(shaderProgram3D->unifrm_sun_position, position[0], position[1], position[2]);
+void shader_program_3D_enable_color_array(ShaderProgram3D* shaderProgram3D, GLboolean enable) {
+    if (shader_sent(&shaderProgram3D->sent.colorArray, &enable, sizeof(GLboolean)))
+        return;
+
+    if (enable) {
+        glEnableVertexAttribArray(shaderProgram3D->attrib_color);
+    } else {
+        glDisableVertexAttribArray(shaderProgram3D->attrib_color);
+
+        // The constant color is undefined after drawing from the array
+        memset(shaderProgram3D->sent.color, 0xff, sizeof(shaderProgram3D->sent.color));
+    }
 }
 
 void shader_program_3D_use(ShaderProgram3D* shaderProgram3D) {
+    if (shader_sent(&boundProgram, &shaderProgram3D->shader_prog, sizeof(GLuint)))
+        return;
+
     glUseProgram(shaderProgram3D->shader_prog);
 }
 
@@ -128,23 +188,37 @@ ShaderProgram2D* shader_program_2D_init(ShaderProgram2D* s) {
     shaderProgram2D->unifrm_projection = glGetUniformLocation(shaderProgram2D->shader_prog, "projection");
     shaderProgram2D->unifrm_sampler = glGetUniformLocation(shaderProgram2D->shader_prog, "sampler");
 
+    memset(&shaderProgram2D->sent, 0, sizeof(shaderProgram2D->sent));
+
     return shaderProgram2D;
 }
 
 void shader_program_2D_destroy(ShaderProgram2D* shaderProgram2D) {
+    if (boundProgram == shaderProgram2D->shader_prog)
+        boundProgram = 0;
+
     glDeleteProgram(shaderProgram2D->shader_prog);
     glDeleteShader(shaderProgram2D->shader_frag);
     glDeleteShader(shaderProgram2D->shader_vert);
 }
 
 void shader_program_2D_update_projection(ShaderProgram2D* shaderProgram2D, float* mat4) {
+    if (shader_sent(shaderProgram2D->sent.projection, mat4, 16*sizeof(float)))
+        return;
+
     glUniformMatrix4fv(shaderProgram2D->unifrm_projection, 1, GL_FALSE, mat4);
 }
 
 void shader_program_2D_update_sampler(ShaderProgram2D* shaderProgram2D, GLint sampler) {
+    if (shader_sent(&shaderProgram2D->sent.sampler, &sampler, sizeof(GLint)))
+        return;
+
     glUniform1i(shaderProgram2D->unifrm_sampler, sampler);
 }
 
 void shader_program_2D_use(ShaderProgram2D* shaderProgram2D) {
+    if (shader_sent(&boundProgram, &shaderProgram2D->shader_prog, sizeof(GLuint)))
+        return;
+
     glUseProgram(shaderProgram2D->shader_prog);
 }
@@ -7,8 +7,14 @@
 
 #include "global.h"
 
+int shader_state_changes();
+void shader_reset_state_changes();
+
 /* ShaderProgram3D */
 
+#define SHADER_3D_CHUNK_ORIGINS_BINDING     0
+#define SHADER_3D_FRAME_BINDING             1
+
 typedef struct {
     GLuint shader_vert;
     GLuint shader_frag;
@@ -16,16 +22,27 @@ typedef struct {
 
     GLint attrib_position;
     GLint attrib_normal;
+    GLint attrib_color;
+    GLint attrib_packed_vertex;
+    GLint attrib_chunk_slot;
+
+    GLint unifrm_use_packed_vertex;
+    GLint unifrm_use_chunk_slot;
 
     GLint unifrm_world_position;
 
     GLint unifrm_model;
-    GLint unifrm_camera;
-    GLint unifrm_projection;
 
-    GLint unifrm_color;
-    GLint unifrm_ambient;
-    GLint unifrm_sun_position;
+    // Last values sent to GL, so updates that change nothing can be skipped.
+    // Uniforms and the generic color attribute all start out as zero
+    struct {
+        float worldPosition[3];
+        float model[16];
+        GLboolean usePackedVertex;
+        GLboolean useChunkSlot;
+        float color[3];
+        GLboolean colorArray;
+    } sent;
 } ShaderProgram3D;
 
 ShaderProgram3D* shader_program_3D_init(ShaderProgram3D* s);
@@ -34,12 +51,12 @@ void shader_program_3D_destroy(ShaderProgram3D* shaderProgram3D);
 void shader_program_3D_update_world_position(ShaderProgram3D* shaderProgram3D, float* position);
 
 void shader_program_3D_update_model(ShaderProgram3D* shaderProgram3D, float* mat4);
-void shader_program_3D_update_camera(ShaderProgram3D* shaderProgram3D, float* mat4);
-void shader_program_3D_update_projection(ShaderProgram3D* shaderProgram3D, float* mat4);
+
+void shader_program_3D_update_use_packed_vertex(ShaderProgram3D* shaderProgram3D, GLboolean usePackedVertex);
+void shader_program_3D_update_use_chunk_slot(ShaderProgram3D* shaderProgram3D, GLboolean useChunkSlot);
 
 void shader_program_3D_update_color(ShaderProgram3D* shaderProgram3D, float r, float g, float b);
-void shader_program_3D_update_ambient(ShaderProgram3D* shaderProgram3D, float a);
-void shader_program_3D_update_sun_position(ShaderProgram3D* shaderProgram3D, float* position);
+void shader_program_3D_enable_color_array(ShaderProgram3D* shaderProgram3D, GLboolean enable);
 
 void shader_program_3D_use(ShaderProgram3D* shaderProgram3D);
 
@@ -56,6 +73,11 @@ typedef struct {
     GLint unifrm_projection;
 
     GLint unifrm_sampler;
+
+    struct {
+        float projection[16];
+        GLint sampler;
+    } sent;
 } ShaderProgram2D;
 
 ShaderProgram2D* shader_program_2D_init(ShaderProgram2D* s);
@@ -4,10 +4,14 @@ precision highp float;
 
 in vec3 Position;
 in vec3 Normal;
+in vec3 Color;
 
-uniform vec3 color;
-uniform vec3 sun_position;
-uniform float ambient;
+layout(std140) uniform Frame {
+    mat4 camera;
+    mat4 projection;
+    vec3 sun_position;
+    float ambient;
+};
 
 out vec4 fragColor;
 
@@ -16,5 +20,5 @@ void main()
     vec3 sun_direction = normalize(sun_position - Position);
     float diff = max(dot(Normal, sun_direction), 0.0);
 
-    fragColor = vec4(color*(ambient+diff), 1.0);
+    fragColor = vec4(Color*(ambient+diff), 1.0);
 }
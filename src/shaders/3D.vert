@@ -2,27 +2,79 @@
 
 in vec3 position;
 in vec3 normal;
+in vec3 color;
+
+in uint packedVertex;
+in uint chunkSlot;
+
+uniform bool usePackedVertex;
+uniform bool useChunkSlot;
 
 uniform vec3 worldPosition;
 
+layout(std140) uniform ChunkOrigins {
+    vec4 chunkOrigins[1024];
+};
+
 uniform mat4 model;
-uniform mat4 camera;
-uniform mat4 projection;
+
+layout(std140) uniform Frame {
+    mat4 camera;
+    mat4 projection;
+    vec3 sun_position;
+    float ambient;
+};
 
 out vec3 Position;
 out vec3 Normal;
+out vec3 Color;
+
+const vec3 normals[6] = vec3[6](
+    vec3( 0.0,  0.0, -1.0),
+    vec3( 0.0,  0.0,  1.0),
+    vec3(-1.0,  0.0,  0.0),
+    vec3( 1.0,  0.0,  0.0),
+    vec3( 0.0,  1.0,  0.0),
+    vec3( 0.0, -1.0,  0.0)
+);
 
 void main()
 {
+    vec3 vertexPosition = position;
+    vec3 vertexNormal = normal;
+    vec3 vertexColor = color;
+
+    if (usePackedVertex) {
+        vertexPosition = vec3(
+            float(packedVertex & 63u),
+            float((packedVertex >> 6) & 63u),
+            float((packedVertex >> 12) & 63u)
+        );
+        vertexNormal = normals[(packedVertex >> 18) & 7u];
+
+        uint blockColor = packedVertex >> 21;
+        vertexColor = vec3(
+            float(blockColor & 7u),
+            float((blockColor >> 3) & 7u),
+            float((blockColor >> 6) & 7u)
+        ) / 7.0;
+    }
+
+    vec3 origin = worldPosition;
+    if (useChunkSlot) {
+        origin = chunkOrigins[chunkSlot].xyz;
+    }
+
     mat4 view = mat4(1.0);
-    view[3] = vec4(worldPosition, 1.0);
-    vec4 worldPosition = view * model * vec4(position, 1.0);
+    view[3] = vec4(origin, 1.0);
+    vec4 worldPosition = view * model * vec4(vertexPosition, 1.0);
 
-    vec4 rotatedNormal = vec4(mat3(model) * normal, 1.0);
+    vec4 rotatedNormal = vec4(normalize(mat3(model) * vertexNormal), 1.0);
 
     vec4 screenPosition = projection * camera * worldPosition;
 
     gl_Position = screenPosition;
     Position = worldPosition.xyz;
     Normal = rotatedNormal.xyz;
+    Color = vertexColor;
 }
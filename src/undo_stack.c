@@ -1,4 +1,7 @@
 #include "undo_stack.h"
+#include "internal/undo_stack.h"
+
+/* Linked list processing callbacks */
 
 void destroy_command(void* commandPtr) {
     Command* command = (Command*)commandPtr;
@@ -8,38 +11,76 @@ void destroy_command(void* commandPtr) {
     free(command->parent);
 }
 
+int compare_spill_addresses(const void* commandAPtr, const void* commandBPtr) {
+    Command* commandA = *(Command**)commandAPtr;
+    Command* commandB = *(Command**)commandBPtr;
+
+    return (commandA->spillAddress > commandB->spillAddress) - (commandA->spillAddress < commandB->spillAddress);
+}
+
+/* Undo stack */
+
 void undo_stack_init(UndoStack* stack) {
     linked_list_init(&stack->commands);
+    stack->top = 0;
+
+    stack->budget = UNDO_STACK_DEFAULT_BUDGET;
+    stack->maxDepth = UNDO_STACK_DEFAULT_MAX_DEPTH;
+    stack->bytes = 0;
+    stack->spillFile = NULL;
+    stack->spillEnd = 0;
+    stack->spillLive = 0;
+
+    stack->stroke = false;
+    stack->strokeNode = NULL;
 }
 
 void undo_stack_destroy(UndoStack* stack) {
     linked_list_destroy(&stack->commands, destroy_command);
+
+    if (stack->spillFile)
+        fclose(stack->spillFile);
 }
 
 void undo_stack_push(UndoStack* stack, Command* command) {
     command->redo(command);
+    command->spilled = false;
+    command->spillAddress = 0;
+    command->spillBytes = 0;
+
+    // Undone commands can no longer be redone once a new one is pushed
+    undo_stack_drop_newer(stack, stack->top ? stack->top->next : stack->commands.head);
 
-    if (!(stack->commands.size == 0 || 
-          stack->top == 0)) {
+    if (stack->top && stack->top == stack->strokeNode) {
         Command* topCommand = (Command*)stack->top->data;
 
-        if (topCommand->id() != 0 && topCommand->id() == command->id()) {
-            topCommand->merge(topCommand, command);
-            return;
+        if (topCommand->id() != 0 && topCommand->id() == command->id() &&
+            undo_stack_page_in(stack, stack->top)) {
+            size_t before = topCommand->size(topCommand);
+            bool merged = topCommand->merge(topCommand, command);
+            stack->bytes += topCommand->size(topCommand) - before;
+
+            if (merged) {
+                destroy_command(command);
+                undo_stack_trim(stack);
+                return;
+            }
         }
     }
 
-    if (stack->commands.size == 0) {
-        linked_list_insert(&stack->commands, command);
-        stack->top = stack->commands.head;
-    } else if (stack->top == 0) {
-        linked_list_insert_before(&stack->commands, stack->commands.head, command);
-        stack->top = stack->commands.head;
-    } else {
+    if (stack->top) {
         linked_list_insert_after(&stack->commands, stack->top, command);
         stack->top = stack->top->next;
+    } else {
+        linked_list_insert(&stack->commands, command);
+        stack->top = stack->commands.head;
     }
 
+    if (stack->stroke && !stack->strokeNode)
+        stack->strokeNode = stack->top;
+
+    stack->bytes += command->size(command);
+    undo_stack_trim(stack);
 }
 
 void undo_stack_undo(UndoStack* stack) {
@@ -49,6 +90,9 @@ void undo_stack_undo(UndoStack* stack) {
 
     Command* topCommand = (Command*)stack->top->data;
 
+    if (!undo_stack_page_in(stack, stack->top))
+        return;
+
     topCommand->undo(topCommand);
 
     stack->top = stack->top->prev;
@@ -59,17 +103,22 @@ void undo_stack_redo(UndoStack* stack) {
         return;
     }
     
-    Command* command;
+    LinkedListNode* node;
     if (stack->top == 0) {
-        command = (Command*)stack->commands.head->data;
+        node = stack->commands.head;
     } else {
         if (stack->top->next) {
-            command = (Command*)stack->top->next->data;
+            node = stack->top->next;
         } else {
             return;
         }
     }
 
+    if (!undo_stack_page_in(stack, node))
+        return;
+
+    Command* command = (Command*)node->data;
+
     command->redo(command);
 
     if (stack->top == 0) {
@@ -77,4 +126,215 @@ void undo_stack_redo(UndoStack* stack) {
     } else {
         stack->top = stack->top->next;
     }
-}
\ No newline at end of file
+}
+
+void undo_stack_begin_stroke(UndoStack* stack) {
+    stack->stroke = true;
+    stack->strokeNode = NULL;
+}
+
+void undo_stack_end_stroke(UndoStack* stack) {
+    stack->stroke = false;
+    stack->strokeNode = NULL;
+}
+
+void undo_stack_set_limits(UndoStack* stack, size_t budget, int maxDepth) {
+    stack->budget = budget;
+    stack->maxDepth = maxDepth;
+
+    undo_stack_trim(stack);
+}
+
+size_t undo_stack_bytes(UndoStack* stack) {
+    return stack->bytes;
+}
+
+int undo_stack_depth(UndoStack* stack) {
+    return stack->commands.size;
+}
+
+UndoStackStats* undo_stack_stats(UndoStack* stack, UndoStackStats* s) {
+    UndoStackStats* stats = s ? s : NEW(UndoStackStats, 1);
+
+    stats->commands = undo_stack_depth(stack);
+    stats->spilled = 0;
+    stats->bytes = undo_stack_bytes(stack);
+    stats->topBytes = 0;
+
+    for (LinkedListNode* node = stack->commands.head; node; node = node->next) {
+        Command* command = (Command*)node->data;
+
+        if (command->spilled)
+            stats->spilled++;
+        if (node == stack->top)
+            stats->topBytes = command->size(command);
+    }
+
+    return stats;
+}
+
+void undo_stack_remove(UndoStack* stack, LinkedListNode* node) {
+    Command* command = (Command*)node->data;
+    stack->bytes -= command->size(command);
+
+    if (node == stack->top)
+        stack->top = node->prev;
+    if (node == stack->strokeNode)
+        stack->strokeNode = NULL;
+
+    if (command->spilled)
+        undo_stack_release(stack, command);
+
+    linked_list_remove(&stack->commands, node, destroy_command);
+}
+
+void undo_stack_drop_older(UndoStack* stack, LinkedListNode* node) {
+    LinkedListNode* next = node->next;
+
+    while (stack->commands.head != next)
+        undo_stack_remove(stack, stack->commands.head);
+}
+
+void undo_stack_drop_newer(UndoStack* stack, LinkedListNode* node) {
+    while (node) {
+        LinkedListNode* next = node->next;
+        undo_stack_remove(stack, node);
+        node = next;
+    }
+}
+
+bool undo_stack_spill(UndoStack* stack, Command* command) {
+    if (!stack->spillFile)
+        stack->spillFile = tmpfile();
+    if (!stack->spillFile)
+        return false;
+
+    fseek(stack->spillFile, stack->spillEnd, SEEK_SET);
+
+    size_t before = command->size(command);
+    if (!command->spill(command, stack->spillFile))
+        return false;
+
+    command->spilled = true;
+    command->spillAddress = stack->spillEnd;
+    command->spillBytes = ftell(stack->spillFile) - stack->spillEnd;
+
+    stack->spillEnd += command->spillBytes;
+    stack->spillLive += command->spillBytes;
+    stack->bytes -= before - command->size(command);
+
+    return true;
+}
+
+bool undo_stack_page_in(UndoStack* stack, LinkedListNode* node) {
+    Command* command = (Command*)node->data;
+
+    if (!command->spilled)
+        return true;
+
+    size_t before = command->size(command);
+    fseek(stack->spillFile, command->spillAddress, SEEK_SET);
+    bool restored = command->restore(command, stack->spillFile);
+    stack->bytes += command->size(command) - before;
+
+    // Without its payload the command cannot be undone or redone, and
+    // neither can anything on the far side of it
+    if (!restored) {
+        if (node == stack->top)
+            undo_stack_drop_older(stack, node);
+        else
+            undo_stack_drop_newer(stack, node);
+
+        return false;
+    }
+
+    command->spilled = false;
+    undo_stack_release(stack, command);
+
+    return true;
+}
+
+void undo_stack_release(UndoStack* stack, Command* command) {
+    stack->spillLive -= command->spillBytes;
+
+    if (command->spillAddress + command->spillBytes == stack->spillEnd)
+        stack->spillEnd = command->spillAddress;
+
+    command->spillBytes = 0;
+
+    if (stack->spillEnd - stack->spillLive > stack->spillLive)
+        undo_stack_compact(stack);
+}
+
+void undo_stack_compact(UndoStack* stack) {
+    int count = 0;
+    Command** spilled = NEW(Command*, stack->commands.size);
+
+    for (LinkedListNode* node = stack->commands.head; node; node = node->next) {
+        Command* command = (Command*)node->data;
+
+        if (command->spilled && command->spillBytes > 0)
+            spilled[count++] = command;
+    }
+
+    // Moving payloads down in address order never overwrites one that has
+    // not been moved yet
+    qsort(spilled, count, sizeof(Command*), compare_spill_addresses);
+
+    long end = 0;
+    char* buffer = NULL;
+    long bufferSize = 0;
+
+    for (int i = 0; i < count; i++) {
+        Command* command = spilled[i];
+
+        if (command->spillAddress != end) {
+            if (command->spillBytes > bufferSize) {
+                bufferSize = command->spillBytes;
+                buffer = realloc(buffer, bufferSize);
+            }
+
+            fseek(stack->spillFile, command->spillAddress, SEEK_SET);
+            fread(buffer, 1, command->spillBytes, stack->spillFile);
+            fseek(stack->spillFile, end, SEEK_SET);
+            fwrite(buffer, 1, command->spillBytes, stack->spillFile);
+
+            command->spillAddress = end;
+        }
+
+        end += command->spillBytes;
+    }
+
+    fflush(stack->spillFile);
+    ftruncate(fileno(stack->spillFile), end);
+    stack->spillEnd = end;
+
+    free(buffer);
+    free(spilled);
+}
+
+void undo_stack_trim(UndoStack* stack) {
+    // Commands past the maximum depth are forgotten, oldest first
+    while (stack->commands.size > stack->maxDepth) {
+        undo_stack_remove(stack, stack->commands.head);
+    }
+
+    // The rest stay undoable, but the oldest payloads wait on disk. The top
+    // and the open stroke are next to be undone or merged into, so they
+    // stay in memory
+    for (LinkedListNode* node = stack->commands.head; node && stack->bytes > stack->budget; node = node->next) {
+        Command* command = (Command*)node->data;
+
+        if (command->spilled || node == stack->top || node == stack->strokeNode)
+            continue;
+
+        if (!undo_stack_spill(stack, command) && !stack->spillFile)
+            break;
+    }
+
+    // Without a spill file, the oldest undone history is dropped instead
+    while (!stack->spillFile && stack->bytes > stack->budget && stack->top &&
+           stack->commands.head != stack->top && stack->commands.head != stack->strokeNode) {
+        undo_stack_remove(stack, stack->commands.head);
+    }
+}
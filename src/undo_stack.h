@@ -2,9 +2,16 @@
 #define UNDO_STACK_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 #include "linked_list.h"
 
+#define UNDO_STACK_DEFAULT_BUDGET       (64 << 20)
+#define UNDO_STACK_DEFAULT_MAX_DEPTH    256
+
 typedef struct Command Command;
 
 struct Command {
@@ -13,18 +20,62 @@ struct Command {
     void (*redo)(Command*);
     int (*id)(void);
     bool (*merge)(Command*, Command*);
+    size_t (*size)(Command*);
+    // Write the payload at the current position of the spill file and
+    // free it, or read it back from there; spill returns false when
+    // nothing was moved out, restore when it could not be read back
+    bool (*spill)(Command*, FILE*);
+    bool (*restore)(Command*, FILE*);
     void (*destroy)(Command*);
+
+    bool spilled;
+    long spillAddress;
+    long spillBytes;
 };
 
 typedef struct {
     LinkedList commands;
     LinkedListNode* top;
+
+    // Past the budget the oldest payloads are spilled to a temporary file,
+    // and past the maximum depth the oldest commands are dropped
+    size_t budget;
+    int maxDepth;
+    size_t bytes;
+    FILE* spillFile;
+
+    // Payloads are appended at spillEnd; once the space left by paged in
+    // and dropped payloads outgrows the live ones, the file is compacted
+    long spillEnd;
+    long spillLive;
+
+    // While a stroke is open, commands with the same non-zero id are
+    // merged into the first one it pushed
+    bool stroke;
+    LinkedListNode* strokeNode;
 } UndoStack;
 
+typedef struct {
+    int commands;
+    int spilled;
+    size_t bytes;
+    // Memory held by the command that would be undone next
+    size_t topBytes;
+} UndoStackStats;
+
 void undo_stack_init(UndoStack* stack);
 void undo_stack_destroy(UndoStack* stack);
 void undo_stack_push(UndoStack* stack, Command* command);
 void undo_stack_undo(UndoStack* stack);
 void undo_stack_redo(UndoStack* stack);
 
-#endif // UNDO_STACK_H
\ No newline at end of file
+void undo_stack_begin_stroke(UndoStack* stack);
+void undo_stack_end_stroke(UndoStack* stack);
+
+void undo_stack_set_limits(UndoStack* stack, size_t budget, int maxDepth);
+size_t undo_stack_bytes(UndoStack* stack);
+int undo_stack_depth(UndoStack* stack);
+
+UndoStackStats* undo_stack_stats(UndoStack* stack, UndoStackStats* stats);
+
+#endif // UNDO_STACK_H
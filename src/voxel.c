@@ -22,6 +22,7 @@ char voxel_process_input(Voxel* voxel) {
     static char f[2];
     static char z[2];
     static char c[2];
+    static char o[2];
 
     static int tab = 0;
 
@@ -104,6 +105,12 @@ char voxel_process_input(Voxel* voxel) {
         picker_set_action(&voxel->picker, PICKER_MOVE);
     }
 
+    o[1] = o[0];
+    o[0] = window_key_is_pressed(&voxel->window, GLFW_KEY_O);
+    if (!o[1] && o[0]) {
+        voxel->renderer.occlusionCulling = !voxel->renderer.occlusionCulling;
+    }
+
     f[1] = f[0];
     f[0] = window_key_is_pressed(&voxel->window, GLFW_KEY_F);
     if (!f[1] && f[0]) {
@@ -166,10 +173,15 @@ char voxel_process_input(Voxel* voxel) {
 void voxel_draw(Voxel* voxel) {
     world_update(&voxel->world, &voxel->camera);
 
+    picker_panel_update(&voxel->pickerPanel);
+
     renderer_clear(&voxel->renderer);
     renderer_render_world(&voxel->renderer, &voxel->world, &voxel->camera);
     renderer_render_picker(&voxel->renderer, &voxel->picker);
     renderer_render_panels(&voxel->renderer, &voxel->panelManager.panels);
+    fps_panel_queue_text(&voxel->fpsPanel, &voxel->renderer);
+    renderer_render_text(&voxel->renderer);
+    renderer_finish(&voxel->renderer);
 
     struct timeval oldFrameTime = voxel->frameTime;
     gettimeofday(&voxel->frameTime, NULL);
@@ -181,6 +193,13 @@ void voxel_draw(Voxel* voxel) {
         long millisElapsed = (elapsed.tv_sec * 1000000 + elapsed.tv_usec) / 1000;
 
         fps_panel_set_fps(&voxel->fpsPanel, 1000.0 / millisElapsed);
+        fps_panel_set_stats(&voxel->fpsPanel, &voxel->renderer.stats, voxel->renderer.occlusionCulling);
+
+        GPUArenaStats arenaStats;
+        fps_panel_set_arena_stats(&voxel->fpsPanel, gpu_arena_stats(&voxel->world.arena, &arenaStats));
+
+        UndoStackStats undoStats;
+        fps_panel_set_undo_stats(&voxel->fpsPanel, undo_stack_stats(&voxel->undoStack, &undoStats));
     }
 }
 
@@ -196,13 +215,14 @@ void voxel_setup(Application* application) {
     voxel_resize(application);
 
     world_init(&voxel->world, "cubes");
+    world_set_load_radius(&voxel->world, ceil(voxel->camera.far / WORLD_CHUNK_LENGTH));
 
     picker_init(&voxel->picker, &voxel->world, &voxel->undoStack);
 
     panel_manager_init(&voxel->panelManager);
 
     fps_panel_init(&voxel->fpsPanel, &voxel->panelManager);
-    fps_panel_set_position(&voxel->fpsPanel, 16, application->window->height - 30);
+    fps_panel_set_position(&voxel->fpsPanel, 16, application->window->height - voxel->fpsPanel.panel.height - 14);
 
     picker_panel_init(&voxel->pickerPanel, &voxel->panelManager, &voxel->picker);
 
@@ -227,7 +247,7 @@ void voxel_main(Application* application) {
 void voxel_resize(Application* application) {
     Voxel* voxel = (Voxel*)application->owner;
 
-    fps_panel_set_position(&voxel->fpsPanel, 16, application->window->height - 30);
+    fps_panel_set_position(&voxel->fpsPanel, 16, application->window->height - voxel->fpsPanel.panel.height - 14);
 
     renderer_resize(&voxel->renderer, application->window->width, application->window->height, &voxel->camera);
 }
@@ -17,6 +17,14 @@ void unload_world_chunk(void* worldChunkPtr, void* worldPtr) {
     world_unload_world_chunk(world, worldChunk);
 }
 
+void remesh_world_chunk(void* worldChunkPtr, void* worldPtr) {
+    WorldChunk* worldChunk = (WorldChunk*)worldChunkPtr;
+    World* world = (World*)worldPtr;
+
+    if (worldChunk->needsMesh || worldChunk->chunk->stale)
+        world_mesh_world_chunk(world, worldChunk);
+}
+
 void destroy_world_chunk(void* worldChunkPtr) {
     WorldChunk* worldChunk = (WorldChunk*)worldChunkPtr;
 
@@ -51,6 +59,31 @@ int compare_world_chunks(void* worldChunkAPtr, void* worldChunkBPtr) {
     return compare_chunk_ids(&worldChunkA->id, &worldChunkB->id);
 }
 
+ChunkID* chunk_id_neighbor(ChunkID* neighborID, ChunkID* chunkID, int face) {
+    static const int offsets[6][3] = {
+        [NORTH]  = {  0,  0, -1 },
+        [SOUTH]  = {  0,  0,  1 },
+        [WEST]   = { -1,  0,  0 },
+        [EAST]   = {  1,  0,  0 },
+        [TOP]    = {  0,  1,  0 },
+        [BOTTOM] = {  0, -1,  0 }
+    };
+
+    neighborID->x = chunkID->x + offsets[face][0];
+    neighborID->y = chunkID->y + offsets[face][1];
+    neighborID->z = chunkID->z + offsets[face][2];
+
+    return neighborID;
+}
+
+unsigned int hash_chunk_id(ChunkID* chunkID) {
+    unsigned int hash = ((unsigned int)chunkID->x * 73856093u) ^
+                        ((unsigned int)chunkID->y * 19349663u) ^
+                        ((unsigned int)chunkID->z * 83492791u);
+
+    return hash % WORLD_CHUNK_BUCKETS;
+}
+
 /* World */
 
 World* world_init(World* world, const char* name) {
@@ -60,79 +93,81 @@ World* world_init(World* world, const char* name) {
 
     linked_list_init(&w->chunks);
 
+    w->chunkBuckets = NEW(LinkedList, WORLD_CHUNK_BUCKETS);
+    for (int i = 0; i < WORLD_CHUNK_BUCKETS; i++) {
+        linked_list_init(&w->chunkBuckets[i]);
+    }
+
     ground_init(&w->ground, 500);
+    gpu_arena_init(&w->arena, sizeof(GLuint));
+
+    w->loadRadius = WORLD_LOAD_RADIUS;
+    w->loaded = 0;
+    w->meshed = 0;
+    memset(w->absent, 0, sizeof(w->absent));
 
     return w;
 }
 
 void world_destroy(World* world) {
     ground_destroy(&world->ground);
-    linked_list_foreach(&world->chunks, unload_world_chunk, world);
+    while (world->chunks.head) {
+        world_unload_world_chunk(world, (WorldChunk*)world->chunks.head->data);
+    }
+    free(world->chunkBuckets);
+    gpu_arena_destroy(&world->arena);
     chunk_dao_destroy(&world->chunkDAO);
 }
 
-LinkedList* world_draw_list(LinkedList* list, Camera* camera) {
-    Box aabb;
-    camera_aabb(&aabb, camera);
-
-    ChunkID chunkIDStart, chunkIDEnd;
-    chunkIDStart.x = floor(aabb.position[0] / WORLD_CHUNK_LENGTH);
-    chunkIDStart.y = floor(aabb.position[1] / WORLD_CHUNK_LENGTH);
-    chunkIDStart.z = floor(aabb.position[2] / WORLD_CHUNK_LENGTH);
-    memcpy(&chunkIDEnd, &chunkIDStart, sizeof(ChunkID));
-
-    int block_position[3] = { chunkIDStart.x * WORLD_CHUNK_LENGTH,
-                              chunkIDStart.y * WORLD_CHUNK_LENGTH,
-                              chunkIDStart.z * WORLD_CHUNK_LENGTH
-                            };
-    float vec[3];
-
-    vec3_scale(vec, aabb.right, aabb.width);
-    vec3_add(vec, aabb.position, vec);
-    while (block_position[0] < vec[0]) {
-        chunkIDEnd.x++;
-        block_position[0] += WORLD_CHUNK_LENGTH;
-    }
+LinkedList* world_load_list(World* world, LinkedList* list, ChunkID* center) {
+    int r = world->loadRadius;
 
-    vec3_scale(vec, aabb.up, aabb.height);
-    vec3_add(vec, aabb.position, vec);
-    while (block_position[1] < vec[1]) {
-        chunkIDEnd.y++;
-        block_position[1] += WORLD_CHUNK_LENGTH;
-    }
+    LinkedList* loadList = linked_list_init(list);
+    for (int x = -r; x <= r; x++) {
+        for (int y = -r; y <= r; y++) {
+            for (int z = -r; z <= r; z++) {
+                if (x*x + y*y + z*z > r*r)
+                    continue;
 
-    vec3_scale(vec, aabb.forward, aabb.length);
-    vec3_add(vec, aabb.position, vec);
-    while (block_position[2] < vec[2]) {
-        chunkIDEnd.z++;
-        block_position[2] += WORLD_CHUNK_LENGTH;
-    }
-
-    LinkedList* drawList = linked_list_init(list);
-    for (int x = chunkIDStart.x; x < chunkIDEnd.x; x++) {
-        for (int y = chunkIDStart.y; y < chunkIDEnd.y; y++) {
-            for (int z = chunkIDStart.z; z < chunkIDEnd.z; z++) {
                 ChunkID* chunkID = NEW(ChunkID, 1);
-                chunkID->x = x;
-                chunkID->y = y;
-                chunkID->z = z;
+                chunkID->x = center->x + x;
+                chunkID->y = center->y + y;
+                chunkID->z = center->z + z;
 
-                linked_list_insert(drawList, chunkID);
+                linked_list_insert(loadList, chunkID);
             }
         }
     }
 
-    return drawList;
+    return loadList;
+}
+
+void world_insert_world_chunk(World* world, WorldChunk* worldChunk) {
+    float origin[] = {
+        worldChunk->id.x * WORLD_CHUNK_LENGTH,
+        worldChunk->id.y * WORLD_CHUNK_LENGTH,
+        worldChunk->id.z * WORLD_CHUNK_LENGTH
+    };
+    mesh_set_arena(&worldChunk->chunk->mesh, &world->arena, origin);
+
+    linked_list_insert_ordered(&world->chunks, worldChunk, compare_world_chunks);
+    linked_list_insert(&world->chunkBuckets[hash_chunk_id(&worldChunk->id)], worldChunk);
 }
 
 Chunk* world_load_world_chunk(World* world, ChunkID* chunkID) {
     Chunk* chunk = chunk_dao_load(&world->chunkDAO, chunkID);
     if (chunk) {
-        chunk_mesh(chunk);
         WorldChunk* worldChunk = NEW(WorldChunk, 1);
         worldChunk->id = *chunkID;
         worldChunk->chunk = chunk;
-        linked_list_insert(&world->chunks, worldChunk);
+        worldChunk->needsMesh = 1;
+        world_insert_world_chunk(world, worldChunk);
+
+        // Neighbors may now have hidden faces along the shared boundary
+        for (int f = 0; f < 6; f++) {
+            ChunkID neighborID;
+            world_invalidate_face(world, chunk_id_neighbor(&neighborID, chunkID, f), f ^ 1);
+        }
     }
     return chunk;
 }
@@ -140,12 +175,257 @@ Chunk* world_load_world_chunk(World* world, ChunkID* chunkID) {
 void world_unload_world_chunk(World* world, WorldChunk* worldChunk) {
     if (worldChunk->chunk->dirty) {
         chunk_dao_save(&world->chunkDAO, &worldChunk->id, worldChunk->chunk);
+
+        int slot = hash_chunk_id(&worldChunk->id) % WORLD_ABSENT_CACHE;
+        if (world->absent[slot] && compare_chunk_ids(&worldChunk->id, &world->absentIDs[slot]) == 0)
+            world->absent[slot] = 0;
     }
 
+    LinkedList* bucket = &world->chunkBuckets[hash_chunk_id(&worldChunk->id)];
+    linked_list_remove(bucket, linked_list_find(bucket, &worldChunk->id, chunk_id_equals_world_chunk), NULL);
+
     LinkedListNode* node = linked_list_find(&world->chunks, &worldChunk->id, chunk_id_equals_world_chunk);
     linked_list_remove(&world->chunks, node, destroy_world_chunk);
 }
 
+WorldChunk* world_get_world_chunk(World* world, ChunkID* chunkID) {
+    LinkedList* bucket = &world->chunkBuckets[hash_chunk_id(chunkID)];
+    LinkedListNode* node = linked_list_find(bucket, chunkID, chunk_id_equals_world_chunk);
+
+    return node ? (WorldChunk*)node->data : NULL;
+}
+
+WorldChunk* world_find_world_chunk(World* world, ChunkID* chunkID, char create) {
+    WorldChunk* worldChunk = world_get_world_chunk(world, chunkID);
+
+    // A chunk outside the loaded area may still be stored on disk. Edits
+    // walk many cells of the same few chunks, so misses are remembered
+    int slot = hash_chunk_id(chunkID) % WORLD_ABSENT_CACHE;
+    char absent = world->absent[slot] && compare_chunk_ids(chunkID, &world->absentIDs[slot]) == 0;
+
+    if (!worldChunk && !absent) {
+        if (world_load_world_chunk(world, chunkID)) {
+            worldChunk = world_get_world_chunk(world, chunkID);
+        } else {
+            world->absentIDs[slot] = *chunkID;
+            world->absent[slot] = 1;
+        }
+    }
+
+    if (!worldChunk && create) {
+        worldChunk = NEW(WorldChunk, 1);
+        worldChunk->id = *chunkID;
+        worldChunk->chunk = chunk_init(NULL, WORLD_CHUNK_LENGTH, WORLD_CHUNK_LENGTH, WORLD_CHUNK_LENGTH);
+        worldChunk->needsMesh = 1;
+        world_insert_world_chunk(world, worldChunk);
+    }
+
+    return worldChunk;
+}
+
+void world_mesh_world_chunk(World* world, WorldChunk* worldChunk) {
+    Chunk* neighbors[6];
+
+    for (int f = 0; f < 6; f++) {
+        ChunkID neighborID;
+        WorldChunk* neighbor = world_get_world_chunk(world, chunk_id_neighbor(&neighborID, &worldChunk->id, f));
+        neighbors[f] = neighbor ? neighbor->chunk : NULL;
+    }
+
+    if (worldChunk->needsMesh) {
+        chunk_mesh(worldChunk->chunk, neighbors);
+    } else {
+        chunk_remesh(worldChunk->chunk, neighbors);
+    }
+    worldChunk->needsMesh = 0;
+    world->meshed++;
+}
+
+void world_invalidate_face(World* world, ChunkID* chunkID, int face) {
+    WorldChunk* worldChunk = world_get_world_chunk(world, chunkID);
+
+    if (worldChunk)
+        chunk_invalidate_face(worldChunk->chunk, face);
+}
+
+void world_invalidate_block(World* world, WorldChunk* worldChunk, int* block_position) {
+    world_invalidate_blocks(world, worldChunk, block_position, block_position);
+}
+
+void world_invalidate_blocks(World* world, WorldChunk* worldChunk, int* low, int* high) {
+    chunk_invalidate_blocks(worldChunk->chunk, low, high);
+
+    int faces[3][2] = {
+        { WEST,   EAST  },
+        { BOTTOM, TOP   },
+        { NORTH,  SOUTH }
+    };
+
+    // A block on the boundary can hide or expose faces of the chunk next to it
+    for (int d = 0; d < 3; d++) {
+        ChunkID neighborID;
+
+        if (low[d] == 0)
+            world_invalidate_face(world, chunk_id_neighbor(&neighborID, &worldChunk->id, faces[d][0]), faces[d][1]);
+        if (high[d] == WORLD_CHUNK_LENGTH - 1)
+            world_invalidate_face(world, chunk_id_neighbor(&neighborID, &worldChunk->id, faces[d][1]), faces[d][0]);
+    }
+}
+
+WorldChunk* world_locate_block(World* world, WorldChunk* worldChunk, int* location, int* block_position, char create) {
+    for (int a = 0; a < 3; a++) {
+        block_position[a] = location[a] % WORLD_CHUNK_LENGTH;
+        if (block_position[a] < 0)
+            block_position[a] += WORLD_CHUNK_LENGTH;
+    }
+
+    ChunkID chunkID;
+    chunkID.x = (location[0] - block_position[0]) / WORLD_CHUNK_LENGTH;
+    chunkID.y = (location[1] - block_position[1]) / WORLD_CHUNK_LENGTH;
+    chunkID.z = (location[2] - block_position[2]) / WORLD_CHUNK_LENGTH;
+
+    // Consecutive cells of a bulk edit mostly stay in the same chunk
+    if (worldChunk && compare_chunk_ids(&chunkID, &worldChunk->id) == 0)
+        return worldChunk;
+
+    return world_find_world_chunk(world, &chunkID, create);
+}
+
+void world_write_block(World* world, WorldChunk* worldChunk, int* block_position, uint16_t data) {
+    Block* block = &worldChunk->chunk->blocks[block_position[0]][block_position[1]][block_position[2]];
+
+    if (block->data == data)
+        return;
+
+    Block written;
+    written.data = data;
+    char activeChanged = block_is_active(block) != block_is_active(&written);
+
+    block->data = data;
+    worldChunk->chunk->dirty = 1;
+
+    // Only a change of shape can affect the faces of neighbouring blocks
+    if (activeChanged) {
+        world_invalidate_block(world, worldChunk, block_position);
+    } else {
+        chunk_invalidate_block(worldChunk->chunk, block_position);
+    }
+}
+
+WorldChunk* world_edit_block(World* world, WorldChunk* worldChunk, int* location, char active, uint16_t color, WorldDelta* delta) {
+    int block_position[3];
+    worldChunk = world_locate_block(world, worldChunk, location, block_position, active);
+
+    // Clearing never needs to create an empty chunk
+    if (!worldChunk)
+        return NULL;
+
+    Block block = worldChunk->chunk->blocks[block_position[0]][block_position[1]][block_position[2]];
+    uint16_t before = block.data;
+
+    block_set_active(&block, active);
+    if (active)
+        block_set_color(&block, color);
+
+    if (block.data != before) {
+        if (delta)
+            world_delta_record(delta, world_delta_index(delta, location), before, block.data);
+
+        world_write_block(world, worldChunk, block_position, block.data);
+    }
+
+    return worldChunk;
+}
+
+void world_blit_row(World* world, WorldBlitTarget* target, Chunk* chunk, int* location, int rotation, int* rowLocation, int length, WorldDelta* delta) {
+    int dx = rowLocation[0] - location[0];
+    int dz = rowLocation[2] - location[2];
+
+    // Source block of the first cell, and the source step for each cell along z
+    int source[2];
+    int step[2];
+    switch (rotation) {
+        case 1:
+            source[0] = -dz;
+            source[1] = dx;
+            step[0] = -1;
+            step[1] = 0;
+            break;
+        case 2:
+            source[0] = -dx;
+            source[1] = -dz;
+            step[0] = 0;
+            step[1] = -1;
+            break;
+        case 3:
+            source[0] = dz;
+            source[1] = -dx;
+            step[0] = 1;
+            step[1] = 0;
+            break;
+        default:
+            source[0] = dx;
+            source[1] = dz;
+            step[0] = 0;
+            step[1] = 1;
+            break;
+    }
+
+    int sourceY = rowLocation[1] - location[1];
+
+    int position[3] = {
+        rowLocation[0] - target->id.x * WORLD_CHUNK_LENGTH,
+        rowLocation[1] - target->id.y * WORLD_CHUNK_LENGTH,
+        rowLocation[2] - target->id.z * WORLD_CHUNK_LENGTH
+    };
+
+    // Stored blocks have to be in place before any cell is compared or
+    // recorded, so a chunk that is only on disk is loaded up front
+    if (!target->found) {
+        target->worldChunk = world_find_world_chunk(world, &target->id, 0);
+        target->found = 1;
+    }
+
+    Block* row = target->worldChunk ? target->worldChunk->chunk->blocks[position[0]][position[1]] : NULL;
+    int index = delta ? world_delta_index(delta, rowLocation) : 0;
+
+    for (int i = 0; i < length; i++, index++, source[0] += step[0], source[1] += step[1]) {
+        Block* sourceBlock = &chunk->blocks[source[0]][sourceY][source[1]];
+        int z = position[2] + i;
+
+        Block previous;
+        previous.data = row ? row[z].data : 0;
+
+        Block block = previous;
+        block_set_active(&block, block_is_active(sourceBlock));
+        if (block_is_active(sourceBlock))
+            block_set_color(&block, block_color(sourceBlock));
+
+        if (block.data == previous.data)
+            continue;
+
+        // Only placing blocks can need a chunk that does not exist yet
+        if (!row) {
+            target->worldChunk = world_find_world_chunk(world, &target->id, 1);
+            row = target->worldChunk->chunk->blocks[position[0]][position[1]];
+        }
+
+        if (delta)
+            world_delta_record(delta, index, previous.data, block.data);
+
+        if (block_is_active(&previous) != block_is_active(&block))
+            target->shapeChanged = 1;
+        row[z] = block;
+
+        target->low[0] = MIN(target->low[0], position[0]);
+        target->low[1] = MIN(target->low[1], position[1]);
+        target->low[2] = MIN(target->low[2], z);
+        target->high[0] = MAX(target->high[0], position[0]);
+        target->high[1] = MAX(target->high[1], position[1]);
+        target->high[2] = MAX(target->high[2], z);
+    }
+}
+
 Block* world_get_block(World* world, int* location) {
     int chunk_position[] = {
         floor((float)location[0] / WORLD_CHUNK_LENGTH),
@@ -170,10 +450,9 @@ Block* world_get_block(World* world, int* location) {
     chunkID.y = chunk_position[1];
     chunkID.z = chunk_position[2];
 
-    LinkedListNode* chunkNode = linked_list_find(&world->chunks, &chunkID, chunk_id_equals_world_chunk);
+    WorldChunk* worldChunk = world_get_world_chunk(world, &chunkID);
 
-    if (chunkNode) {
-        WorldChunk* worldChunk = (WorldChunk*)chunkNode->data;
+    if (worldChunk) {
         Block* block = &worldChunk->chunk->blocks[block_position[0]][block_position[1]][block_position[2]];
 
         return block;
@@ -206,24 +485,24 @@ void world_block_set_active(World* world, int* location, char active) {
     chunkID.y = chunk_position[1];
     chunkID.z = chunk_position[2];
 
-    LinkedListNode* chunkNode = linked_list_find(&world->chunks, &chunkID, chunk_id_equals_world_chunk);
+    WorldChunk* worldChunk = world_get_world_chunk(world, &chunkID);
 
     Chunk* chunk;
-    if (chunkNode) {
-        WorldChunk* worldChunk = (WorldChunk*)chunkNode->data;
+    if (worldChunk) {
         chunk = worldChunk->chunk;
     } else {
         chunk = chunk_init(NULL, WORLD_CHUNK_LENGTH, WORLD_CHUNK_LENGTH, WORLD_CHUNK_LENGTH);
-        WorldChunk* worldChunk = NEW(WorldChunk, 1);
+        worldChunk = NEW(WorldChunk, 1);
         worldChunk->id = chunkID;
         worldChunk->chunk = chunk;
-        linked_list_insert_ordered(&world->chunks, worldChunk, compare_world_chunks);
+        worldChunk->needsMesh = 1;
+        world_insert_world_chunk(world, worldChunk);
     }
 
     Block* block = &chunk->blocks[block_position[0]][block_position[1]][block_position[2]];
     block_set_active(block, active);
     chunk->dirty = 1;
-    chunk_mesh(chunk);
+    world_invalidate_block(world, worldChunk, block_position);
 }
 
 void world_block_set_color(World* world, int* location, uint16_t color) {
@@ -250,41 +529,158 @@ void world_block_set_color(World* world, int* location, uint16_t color) {
     chunkID.y = chunk_position[1];
     chunkID.z = chunk_position[2];
 
-    LinkedListNode* chunkNode = linked_list_find(&world->chunks, &chunkID, chunk_id_equals_world_chunk);
+    WorldChunk* worldChunk = world_get_world_chunk(world, &chunkID);
 
     Chunk* chunk;
-    if (chunkNode) {
-        WorldChunk* worldChunk = (WorldChunk*)chunkNode->data;
+    if (worldChunk) {
         chunk = worldChunk->chunk;
     } else {
         chunk = chunk_init(NULL, WORLD_CHUNK_LENGTH, WORLD_CHUNK_LENGTH, WORLD_CHUNK_LENGTH);
-        WorldChunk* worldChunk = NEW(WorldChunk, 1);
+        worldChunk = NEW(WorldChunk, 1);
         worldChunk->id = chunkID;
         worldChunk->chunk = chunk;
-        linked_list_insert_ordered(&world->chunks, worldChunk, compare_world_chunks);
+        worldChunk->needsMesh = 1;
+        world_insert_world_chunk(world, worldChunk);
     }
 
     Block* block = &chunk->blocks[block_position[0]][block_position[1]][block_position[2]];
     block_set_color(block, color);
     chunk->dirty = 1;
-    chunk_mesh(chunk);
+    chunk_invalidate_block(chunk, block_position);
 }
 
 Chunk* world_copy_chunk(World* world, Box* box) {
+    return world_read_region(world, box, 0);
+}
+
+Chunk* world_cut_chunk(World* world, Box* box) {
+    return world_read_region(world, box, 1);
+}
+
+Box* world_chunk_region(Box* r, Chunk* chunk, int* location, int rotation) {
+    Box* region = box_init(r);
+
+    region->width = chunk->width;
+    region->height = chunk->height;
+    region->length = chunk->length;
+
+    region->position[0] = location[0];
+    region->position[1] = location[1];
+    region->position[2] = location[2];
+
+    if (rotation % 2 == 1) {
+        float temp = region->width;
+        region->width = region->length;
+        region->length = temp;
+    }
+
+    switch (rotation) {
+        case 0:
+            break;
+        case 1:
+            region->position[2] -= region->length - 1;
+            break;
+        case 2:
+            region->position[0] -= region->width - 1;
+            region->position[2] -= region->length - 1;
+            break;
+        case 3:
+            region->position[0] -= region->width - 1;
+            break;
+        default:
+            break;
+    }
+
+    return region;
+}
+
+Chunk* world_read_region(World* world, Box* box, char cut) {
     Chunk* chunk = chunk_init(NULL, box->width, box->height, box->length);
-    for (int x = 0; x < box->width; x++) {
-        for (int y = 0; y < box->height; y++) {
-            for (int z = 0; z < box->length; z++) {
-                int location[3] = {
-                    box->position[0] + x,
-                    box->position[1] + y,
-                    box->position[2] + z
-                };
 
-                Block* block = world_get_block(world, location);
+    int low[3] = { box->position[0], box->position[1], box->position[2] };
+    int high[3] = { low[0] + box->width - 1, low[1] + box->height - 1, low[2] + box->length - 1 };
+
+    ChunkID lowID;
+    lowID.x = floor((float)low[0] / WORLD_CHUNK_LENGTH);
+    lowID.y = floor((float)low[1] / WORLD_CHUNK_LENGTH);
+    lowID.z = floor((float)low[2] / WORLD_CHUNK_LENGTH);
+
+    ChunkID highID;
+    highID.x = floor((float)high[0] / WORLD_CHUNK_LENGTH);
+    highID.y = floor((float)high[1] / WORLD_CHUNK_LENGTH);
+    highID.z = floor((float)high[2] / WORLD_CHUNK_LENGTH);
+
+    ChunkID id;
+    for (id.x = lowID.x; id.x <= highID.x; id.x++) {
+        for (id.y = lowID.y; id.y <= highID.y; id.y++) {
+            for (id.z = lowID.z; id.z <= highID.z; id.z++) {
+                WorldChunk* worldChunk = world_get_world_chunk(world, &id);
+                Chunk* source = worldChunk ? worldChunk->chunk : NULL;
+
+                // A copy reads chunks outside the loaded area straight from
+                // disk; a cut has to bring them in to clear and save them
+                if (!source && cut && world_load_world_chunk(world, &id)) {
+                    worldChunk = world_get_world_chunk(world, &id);
+                    source = worldChunk->chunk;
+                } else if (!source && !cut) {
+                    source = chunk_dao_load(&world->chunkDAO, &id);
+                }
+
+                // Never stored, so the whole chunk is air
+                if (!source)
+                    continue;
+
+                int origin[3] = { id.x * WORLD_CHUNK_LENGTH, id.y * WORLD_CHUNK_LENGTH, id.z * WORLD_CHUNK_LENGTH };
+                int from[3], to[3];
+                for (int a = 0; a < 3; a++) {
+                    from[a] = MAX(low[a], origin[a]) - origin[a];
+                    to[a] = MIN(high[a], origin[a] + WORLD_CHUNK_LENGTH - 1) - origin[a];
+                }
+
+                int length = to[2] - from[2] + 1;
+                int cleared[3] = { WORLD_CHUNK_LENGTH, WORLD_CHUNK_LENGTH, WORLD_CHUNK_LENGTH };
+                int clearedHigh[3] = { -1, -1, -1 };
+                char shapeChanged = 0;
+
+                for (int x = from[0]; x <= to[0]; x++) {
+                    for (int y = from[1]; y <= to[1]; y++) {
+                        Block* row = &source->blocks[x][y][from[2]];
+                        Block* copy = &chunk->blocks[origin[0] + x - low[0]][origin[1] + y - low[1]][origin[2] + from[2] - low[2]];
+                        memcpy(copy, row, length * sizeof(Block));
+
+                        if (!cut)
+                            continue;
+
+                        for (int z = 0; z < length; z++) {
+                            Block block = row[z];
+                            block_set_color(&block, 0);
+                            block_set_active(&block, 0);
+
+                            if (block.data == row[z].data)
+                                continue;
+
+                            int position[3] = { x, y, from[2] + z };
+                            for (int a = 0; a < 3; a++) {
+                                cleared[a] = MIN(cleared[a], position[a]);
+                                clearedHigh[a] = MAX(clearedHigh[a], position[a]);
+                            }
+                            shapeChanged |= block_is_active(&row[z]);
+                            row[z] = block;
+                        }
+                    }
+                }
 
-                if (block) {
-                    chunk->blocks[x][y][z].data = block->data;
+                if (!worldChunk) {
+                    chunk_destroy(source);
+                    free(source);
+                } else if (clearedHigh[0] >= 0) {
+                    source->dirty = 1;
+
+                    if (shapeChanged) {
+                        world_invalidate_blocks(world, worldChunk, cleared, clearedHigh);
+                    } else {
+                        chunk_invalidate_blocks(source, cleared, clearedHigh);
+                    }
                 }
             }
         }
@@ -293,72 +689,153 @@ Chunk* world_copy_chunk(World* world, Box* box) {
     return chunk;
 }
 
-Chunk* world_cut_chunk(World* world, Box* box) {
-    Chunk* chunk = chunk_init(NULL, box->width, box->height, box->length);
-    for (int x = 0; x < box->width; x++) {
-        for (int y = 0; y < box->height; y++) {
-            for (int z = 0; z < box->length; z++) {
-                int location[3] = {
-                    box->position[0] + x,
-                    box->position[1] + y,
-                    box->position[2] + z
-                };
+void world_set_chunk(World* world, Chunk* chunk, int* location, int rotation, WorldDelta* delta) {
+    Box region;
+    world_chunk_region(&region, chunk, location, rotation);
+
+    int low[3] = { region.position[0], region.position[1], region.position[2] };
+    int high[3] = { low[0] + region.width - 1, low[1] + region.height - 1, low[2] + region.length - 1 };
+
+    ChunkID lowID;
+    lowID.x = floor((float)low[0] / WORLD_CHUNK_LENGTH);
+    lowID.y = floor((float)low[1] / WORLD_CHUNK_LENGTH);
+    lowID.z = floor((float)low[2] / WORLD_CHUNK_LENGTH);
+
+    ChunkID highID;
+    highID.x = floor((float)high[0] / WORLD_CHUNK_LENGTH);
+    highID.y = floor((float)high[1] / WORLD_CHUNK_LENGTH);
+    highID.z = floor((float)high[2] / WORLD_CHUNK_LENGTH);
+
+    int slabHeight = highID.y - lowID.y + 1;
+    int slabLength = highID.z - lowID.z + 1;
+    WorldBlitTarget* targets = NEW(WorldBlitTarget, slabHeight * slabLength);
+
+    // Destination chunks are written one slab of equal x at a time, still
+    // visiting cells in region order so recorded spans come out sorted
+    for (int chunkX = lowID.x; chunkX <= highID.x; chunkX++) {
+        for (int t = 0; t < slabHeight * slabLength; t++) {
+            WorldBlitTarget* target = &targets[t];
+            target->id.x = chunkX;
+            target->id.y = lowID.y + t / slabLength;
+            target->id.z = lowID.z + t % slabLength;
+            target->worldChunk = NULL;
+            target->found = 0;
+            target->shapeChanged = 0;
+            for (int a = 0; a < 3; a++) {
+                target->low[a] = WORLD_CHUNK_LENGTH;
+                target->high[a] = -1;
+            }
+        }
+
+        int fromX = MAX(low[0], chunkX * WORLD_CHUNK_LENGTH);
+        int toX = MIN(high[0], (chunkX + 1) * WORLD_CHUNK_LENGTH - 1);
 
-                Block* block = world_get_block(world, location);
+        for (int x = fromX; x <= toX; x++) {
+            for (int y = low[1]; y <= high[1]; y++) {
+                int chunkY = floor((float)y / WORLD_CHUNK_LENGTH);
 
-                if (block) {
-                    chunk->blocks[x][y][z].data = block->data;
+                for (int chunkZ = lowID.z; chunkZ <= highID.z; chunkZ++) {
+                    int fromZ = MAX(low[2], chunkZ * WORLD_CHUNK_LENGTH);
+                    int toZ = MIN(high[2], (chunkZ + 1) * WORLD_CHUNK_LENGTH - 1);
+                    int rowLocation[3] = { x, y, fromZ };
+
+                    WorldBlitTarget* target = &targets[(chunkY - lowID.y) * slabLength + chunkZ - lowID.z];
+                    world_blit_row(world, target, chunk, location, rotation, rowLocation, toZ - fromZ + 1, delta);
                 }
+            }
+        }
+
+        for (int t = 0; t < slabHeight * slabLength; t++) {
+            WorldBlitTarget* target = &targets[t];
 
-                world_block_set_color(world, location, 0);
-                world_block_set_active(world, location, 0);
+            if (target->high[0] < 0)
+                continue;
+
+            target->worldChunk->chunk->dirty = 1;
+
+            if (target->shapeChanged) {
+                world_invalidate_blocks(world, target->worldChunk, target->low, target->high);
+            } else {
+                chunk_invalidate_blocks(target->worldChunk->chunk, target->low, target->high);
             }
         }
     }
 
-    return chunk;
+    free(targets);
 }
 
-void world_set_chunk(World* world, Chunk* chunk, int* location, int rotation) {
-    for (int x = 0; x < chunk->width; x++) {
-        for (int y = 0; y < chunk->height; y++) {
-            for (int z = 0; z < chunk->length; z++) {
-                Block* block = &chunk->blocks[x][y][z];
-                int blockLocation[3];
-
-                blockLocation[1] = location[1] + y;
-                switch (rotation) {
-                    case 0:
-                        blockLocation[0] = location[0] + x;
-                        blockLocation[2] = location[2] + z;
-                        break;
-                    case 1:
-                        blockLocation[0] = location[0] + z;
-                        blockLocation[2] = location[2] - x;
-                        break;
-                    case 2:
-                        blockLocation[0] = location[0] - x;
-                        blockLocation[2] = location[2] - z;
-                        break;
-                    case 3:
-                        blockLocation[0] = location[0] - z;
-                        blockLocation[2] = location[2] + x;
-                        break;
-                }
-                if (block_is_active(block)) {
-                    world_block_set_active(world, blockLocation, 1);
-                    world_block_set_color(world, blockLocation, block_color(block));
-                } else {
-                    world_block_set_active(world, blockLocation, 0);
-                }
+void world_fill_region(World* world, Box* region, char active, uint16_t color, WorldDelta* delta) {
+    WorldChunk* worldChunk = NULL;
+
+    for (int x = 0; x < region->width; x++) {
+        for (int y = 0; y < region->height; y++) {
+            for (int z = 0; z < region->length; z++) {
+                int location[3] = {
+                    region->position[0] + x,
+                    region->position[1] + y,
+                    region->position[2] + z
+                };
+                worldChunk = world_edit_block(world, worldChunk, location, active, color, delta);
             }
         }
     }
 }
 
+void world_apply_delta(World* world, WorldDelta* delta, char undo) {
+    WorldChunk* worldChunk = NULL;
+
+    for (int s = 0; s < delta->spanCount; s++) {
+        WorldDeltaSpan* span = &delta->spans[s];
+        Block block;
+        block.data = undo ? span->before : span->after;
+
+        for (int i = span->index; i < span->index + span->count; i++) {
+            int location[3];
+            int block_position[3];
+            world_delta_location(delta, i, location);
+
+            worldChunk = world_locate_block(world, worldChunk, location, block_position, block_is_active(&block));
+            if (worldChunk)
+                world_write_block(world, worldChunk, block_position, block.data);
+        }
+    }
+}
+
+void world_set_load_radius(World* world, int radius) {
+    world->loadRadius = radius;
+    world->loaded = 0;
+}
+
 void world_update(World* world, Camera* camera) {
-    LinkedList drawList;
-    world_draw_list(&drawList, camera);
+    ChunkID center;
+    center.x = floor(camera->position[0] / WORLD_CHUNK_LENGTH);
+    center.y = floor(camera->position[1] / WORLD_CHUNK_LENGTH);
+    center.z = floor(camera->position[2] / WORLD_CHUNK_LENGTH);
+
+    // The load set only changes when the camera crosses into another chunk
+    if (!world->loaded || compare_chunk_ids(&center, &world->loadCenter) != 0) {
+        world->loadCenter = center;
+        world->loaded = 1;
+
+        world_load_chunks(world, &center);
+    }
+
+    // Each chunk touched by loads or edits since the last update is meshed once
+    world->meshed = 0;
+    linked_list_foreach(&world->chunks, remesh_world_chunk, world);
+
+    if (!world->meshed) {
+        GPUArenaStats stats;
+        gpu_arena_stats(&world->arena, &stats);
+
+        if (stats.fragmentation > WORLD_ARENA_DEFRAGMENT_THRESHOLD)
+            gpu_arena_defragment(&world->arena);
+    }
+}
+
+void world_load_chunks(World* world, ChunkID* center) {
+    LinkedList loadList;
+    world_load_list(world, &loadList, center);
 
     LinkedList chunksToUnload;
     LinkedList chunksToLoad;
@@ -366,28 +843,28 @@ void world_update(World* world, Camera* camera) {
     linked_list_init(&chunksToUnload);
     linked_list_init(&chunksToLoad);
 
-    LinkedListNode* drawListNode = drawList.head;
+    LinkedListNode* loadListNode = loadList.head;
     LinkedListNode* chunksListNode = world->chunks.head;
 
-    while (drawListNode || chunksListNode) {
-        if (!drawListNode) {
+    while (loadListNode || chunksListNode) {
+        if (!loadListNode) {
             WorldChunk* worldChunk = (WorldChunk*)chunksListNode->data;
             linked_list_insert(&chunksToUnload, worldChunk);
             chunksListNode = chunksListNode->next;
         } else if (!chunksListNode) {
-            ChunkID* drawListChunkID = (ChunkID*)drawListNode->data;
-            linked_list_insert(&chunksToLoad, drawListChunkID);
-            drawListNode = drawListNode->next;
+            ChunkID* loadListChunkID = (ChunkID*)loadListNode->data;
+            linked_list_insert(&chunksToLoad, loadListChunkID);
+            loadListNode = loadListNode->next;
         } else {
-            ChunkID* drawListChunkID = (ChunkID*)drawListNode->data;
+            ChunkID* loadListChunkID = (ChunkID*)loadListNode->data;
             WorldChunk* worldChunk = (WorldChunk*)chunksListNode->data;
-            int comparison = compare_chunk_ids(drawListChunkID, &worldChunk->id);
+            int comparison = compare_chunk_ids(loadListChunkID, &worldChunk->id);
 
             if (comparison < 0) {
-                linked_list_insert(&chunksToLoad, drawListChunkID);
-                drawListNode = drawListNode->next;
+                linked_list_insert(&chunksToLoad, loadListChunkID);
+                loadListNode = loadListNode->next;
             } else if (comparison == 0) {
-                drawListNode = drawListNode->next;
+                loadListNode = loadListNode->next;
                 chunksListNode = chunksListNode->next;
             } else {
                 linked_list_insert(&chunksToUnload, worldChunk);
@@ -402,20 +879,228 @@ void world_update(World* world, Camera* camera) {
     linked_list_destroy(&chunksToLoad, NULL);
     linked_list_destroy(&chunksToUnload, NULL);
 
-    linked_list_destroy(&drawList, free);
+    linked_list_destroy(&loadList, free);
 }
 
 void world_clear_region(World* world, Box* region) {
-    for (int x = 0; x < region->width; x++) {
-        for (int y = 0; y < region->height; y++) {
-            for (int z = 0; z < region->length; z++) {
-                int location[3] = {
-                    region->position[0] + x,
-                    region->position[1] + y,
-                    region->position[2] + z
-                };
-                world_block_set_active(world, location, 0);
+    world_fill_region(world, region, 0, 0, NULL);
+}
+
+LinkedList* world_visible_list(World* world, LinkedList* list, Camera* camera, Frustum* frustum) {
+    LinkedList* visibleList = linked_list_init(list);
+
+    int r = world->loadRadius;
+    int side = 2 * r + 1;
+    int cells = side * side * side;
+
+    ChunkID center;
+    center.x = floor(camera->position[0] / WORLD_CHUNK_LENGTH);
+    center.y = floor(camera->position[1] / WORLD_CHUNK_LENGTH);
+    center.z = floor(camera->position[2] / WORLD_CHUNK_LENGTH);
+
+    VisibilityStep* queue = NEW(VisibilityStep, cells);
+    char* visited = NEW(char, cells);
+    memset(visited, 0, cells);
+
+    int head = 0;
+    int tail = 0;
+
+    queue[tail].id = center;
+    queue[tail].entryFace = -1;
+    queue[tail].directions = 0;
+    tail++;
+    visited[(r * side + r) * side + r] = 1;
+
+    // Breadth-first search outward from the camera, only passing through a chunk
+    // between faces that are connected by air inside it
+    while (head < tail) {
+        VisibilityStep* step = &queue[head++];
+        WorldChunk* worldChunk = world_get_world_chunk(world, &step->id);
+
+        if (worldChunk && worldChunk->chunk->mesh.quads.size)
+            linked_list_insert(visibleList, worldChunk);
+
+        for (int f = 0; f < 6; f++) {
+            // Never step back toward the camera
+            if (step->directions & (1 << (f ^ 1)))
+                continue;
+
+            if (worldChunk && step->entryFace >= 0 && !chunk_faces_connected(worldChunk->chunk, step->entryFace, f))
+                continue;
+
+            ChunkID id;
+            chunk_id_neighbor(&id, &step->id, f);
+
+            int dx = id.x - center.x;
+            int dy = id.y - center.y;
+            int dz = id.z - center.z;
+
+            if (abs(dx) > r || abs(dy) > r || abs(dz) > r)
+                continue;
+
+            int index = ((dx + r) * side + (dy + r)) * side + (dz + r);
+            if (visited[index])
+                continue;
+
+            Box box;
+            box_init(&box);
+            box.position[0] = id.x * WORLD_CHUNK_LENGTH;
+            box.position[1] = id.y * WORLD_CHUNK_LENGTH;
+            box.position[2] = id.z * WORLD_CHUNK_LENGTH;
+            box.width = WORLD_CHUNK_LENGTH;
+            box.height = WORLD_CHUNK_LENGTH;
+            box.length = WORLD_CHUNK_LENGTH;
+
+            if (!frustum_intersects_box(frustum, &box))
+                continue;
+
+            visited[index] = 1;
+
+            queue[tail].id = id;
+            queue[tail].entryFace = f ^ 1;
+            queue[tail].directions = step->directions | (1 << f);
+            tail++;
+        }
+    }
+
+    free(visited);
+    free(queue);
+
+    return visibleList;
+}
+
+char world_chunk_is_empty(WorldChunk* worldChunk) {
+    // A ray entering a chunk from outside can only stop at a block face it
+    // sees from air, and every such face is in an up to date mesh. This says
+    // nothing about a ray that starts inside the chunk
+    return !worldChunk->needsMesh && !worldChunk->chunk->stale && !worldChunk->chunk->mesh.quads.size;
+}
+
+void world_ray_init(WorldRay* ray, float* origin, float* direction, float cellSize, float t, int* low, int* high) {
+    ray->t = t;
+    ray->axis = -1;
+
+    for (int a = 0; a < 3; a++) {
+        ray->cell[a] = floor((origin[a] + direction[a] * t) / cellSize);
+
+        // Rounding can land a ray that starts on a cell boundary in the wrong cell
+        if (low && ray->cell[a] < low[a])
+            ray->cell[a] = low[a];
+        if (high && ray->cell[a] > high[a])
+            ray->cell[a] = high[a];
+
+        if (direction[a] > 0) {
+            ray->step[a] = 1;
+            ray->tDelta[a] = cellSize / direction[a];
+            ray->tMax[a] = ((ray->cell[a] + 1) * cellSize - origin[a]) / direction[a];
+        } else if (direction[a] < 0) {
+            ray->step[a] = -1;
+            ray->tDelta[a] = -cellSize / direction[a];
+            ray->tMax[a] = (ray->cell[a] * cellSize - origin[a]) / direction[a];
+        } else {
+            ray->step[a] = 0;
+            ray->tDelta[a] = INFINITY;
+            ray->tMax[a] = INFINITY;
+        }
+    }
+}
+
+void world_ray_step(WorldRay* ray) {
+    int a = 0;
+    if (ray->tMax[1] < ray->tMax[a])
+        a = 1;
+    if (ray->tMax[2] < ray->tMax[a])
+        a = 2;
+
+    ray->cell[a] += ray->step[a];
+    ray->t = ray->tMax[a];
+    ray->tMax[a] += ray->tDelta[a];
+    ray->axis = a;
+}
+
+void world_ray_hit(WorldRay* ray, WorldRayHit* hit) {
+    static const int lowFaces[3]  = { WEST, BOTTOM, NORTH };
+    static const int highFaces[3] = { EAST, TOP,    SOUTH };
+
+    memcpy(hit->position, ray->cell, sizeof(hit->position));
+    memcpy(hit->adjacent, ray->cell, sizeof(hit->adjacent));
+    hit->face = -1;
+
+    if (ray->axis >= 0) {
+        int a = ray->axis;
+        hit->adjacent[a] -= ray->step[a];
+        hit->face = ray->step[a] > 0 ? lowFaces[a] : highFaces[a];
+    }
+}
+
+char world_cast_ray(World* world, float* origin, float* direction, float maxDistance, WorldRayHit* hit) {
+    // Everything below y = 0 is solid ground
+    float limit = maxDistance;
+    char ground = 0;
+    if (origin[1] < 0) {
+        limit = 0;
+        ground = 1;
+    } else if (direction[1] < 0 && -origin[1] / direction[1] <= maxDistance) {
+        limit = -origin[1] / direction[1];
+        ground = 1;
+    }
+
+    // Walk the chunk grid first, and only walk blocks inside chunks that can be hit
+    WorldRay chunkRay;
+    world_ray_init(&chunkRay, origin, direction, WORLD_CHUNK_LENGTH, 0, NULL, NULL);
+
+    while (chunkRay.t <= limit) {
+        ChunkID chunkID;
+        chunkID.x = chunkRay.cell[0];
+        chunkID.y = chunkRay.cell[1];
+        chunkID.z = chunkRay.cell[2];
+
+        WorldChunk* worldChunk = world_get_world_chunk(world, &chunkID);
+
+        // The chunk holding the origin is always walked, since the ray may
+        // start inside a solid block there
+        if (worldChunk && (chunkRay.axis < 0 || !world_chunk_is_empty(worldChunk))) {
+            int low[3], high[3];
+            for (int a = 0; a < 3; a++) {
+                low[a] = chunkRay.cell[a] * WORLD_CHUNK_LENGTH;
+                high[a] = low[a] + WORLD_CHUNK_LENGTH - 1;
+            }
+
+            WorldRay blockRay;
+            world_ray_init(&blockRay, origin, direction, 1, chunkRay.t, low, high);
+            blockRay.axis = chunkRay.axis;
+
+            while (blockRay.t <= limit &&
+                   blockRay.cell[0] >= low[0] && blockRay.cell[0] <= high[0] &&
+                   blockRay.cell[1] >= low[1] && blockRay.cell[1] <= high[1] &&
+                   blockRay.cell[2] >= low[2] && blockRay.cell[2] <= high[2]) {
+                Block* block = &worldChunk->chunk->blocks[blockRay.cell[0] - low[0]][blockRay.cell[1] - low[1]][blockRay.cell[2] - low[2]];
+
+                if (block_is_active(block)) {
+                    world_ray_hit(&blockRay, hit);
+                    return 1;
+                }
+
+                world_ray_step(&blockRay);
             }
         }
+
+        world_ray_step(&chunkRay);
     }
-}
\ No newline at end of file
+
+    if (!ground)
+        return 0;
+
+    // The ray reached the ground before hitting any block
+    WorldRay groundRay;
+    world_ray_init(&groundRay, origin, direction, 1, limit, NULL, NULL);
+
+    if (origin[1] >= 0) {
+        groundRay.cell[1] = -1;
+        groundRay.axis = 1;
+    }
+
+    world_ray_hit(&groundRay, hit);
+
+    return 1;
+}
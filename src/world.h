@@ -2,6 +2,12 @@
 #define WORLD_H
 
 #define WORLD_CHUNK_LENGTH    16
+#define WORLD_LOAD_RADIUS      7
+#define WORLD_CHUNK_BUCKETS 1024
+#define WORLD_ABSENT_CACHE    64
+
+// Compact the arena on an idle update once this share of its free space is in holes
+#define WORLD_ARENA_DEFRAGMENT_THRESHOLD 0.25
 
 #include <stdlib.h>
 
@@ -11,31 +17,65 @@
 #include "chunk_dao.h"
 #include "linked_list.h"
 #include "ground.h"
+#include "gpu_arena.h"
+#include "world_delta.h"
 
 typedef struct {
     ChunkID id;
     Chunk* chunk;
+    char needsMesh;
 } WorldChunk;
 
+typedef struct {
+    int position[3];
+    // Cell the ray was in just before the hit, next to the entry face
+    int adjacent[3];
+    // Face of the hit block the ray came in through, or -1 if it started inside
+    int face;
+} WorldRayHit;
+
 typedef struct {
     ChunkDAO chunkDAO;
     LinkedList chunks;
+    LinkedList* chunkBuckets;
     Ground ground;
+    GPUArena arena;
+
+    int loadRadius;
+    ChunkID loadCenter;
+    char loaded;
+    int meshed;
+
+    // Recent chunks found not to be stored on disk, by hash
+    ChunkID absentIDs[WORLD_ABSENT_CACHE];
+    char absent[WORLD_ABSENT_CACHE];
 } World;
 
 World* world_init(World* world, const char* name);
 void world_destroy(World* world);
 
+WorldChunk* world_get_world_chunk(World* world, ChunkID* chunkID);
+
 Block* world_get_block(World* world, int* location);
 void world_block_set_active(World* world, int* location, char active);
 void world_block_set_color(World* world, int* location, uint16_t color);
 
 Chunk* world_copy_chunk(World* world, Box* box);
 Chunk* world_cut_chunk(World* world, Box* box);
-void world_set_chunk(World* world, Chunk* chunk, int* location, int rotation);
+Box* world_chunk_region(Box* region, Chunk* chunk, int* location, int rotation);
+
+// Bulk edits record every block they change into delta when it is not NULL
+void world_set_chunk(World* world, Chunk* chunk, int* location, int rotation, WorldDelta* delta);
+void world_fill_region(World* world, Box* region, char active, uint16_t color, WorldDelta* delta);
+void world_apply_delta(World* world, WorldDelta* delta, char undo);
 
 void world_clear_region(World* world, Box* region);
 
+void world_set_load_radius(World* world, int radius);
 void world_update(World* world, Camera* camera);
 
+LinkedList* world_visible_list(World* world, LinkedList* list, Camera* camera, Frustum* frustum);
+
+char world_cast_ray(World* world, float* origin, float* direction, float maxDistance, WorldRayHit* hit);
+
 #endif // WORLD_H
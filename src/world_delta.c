@@ -0,0 +1,298 @@
+#include "world_delta.h"
+#include "internal/world_delta.h"
+
+WorldDelta* world_delta_init(WorldDelta* d, Box* region) {
+    WorldDelta* delta = d ? d : NEW(WorldDelta, 1);
+
+    delta->position[0] = region->position[0];
+    delta->position[1] = region->position[1];
+    delta->position[2] = region->position[2];
+
+    delta->size[0] = region->width;
+    delta->size[1] = region->height;
+    delta->size[2] = region->length;
+
+    delta->spans = NULL;
+    delta->spanCount = 0;
+    delta->spanCapacity = 0;
+
+    delta->spilled = false;
+
+    return delta;
+}
+
+void world_delta_destroy(WorldDelta* delta) {
+    free(delta->spans);
+}
+
+int world_delta_index(WorldDelta* delta, int* location) {
+    return ((location[0] - delta->position[0]) * delta->size[1] +
+            (location[1] - delta->position[1])) * delta->size[2] +
+            (location[2] - delta->position[2]);
+}
+
+int* world_delta_location(WorldDelta* delta, int index, int* location) {
+    location[2] = delta->position[2] + index % delta->size[2];
+    index /= delta->size[2];
+    location[1] = delta->position[1] + index % delta->size[1];
+    location[0] = delta->position[0] + index / delta->size[1];
+
+    return location;
+}
+
+void world_delta_record(WorldDelta* delta, int index, uint16_t before, uint16_t after) {
+    if (delta->spanCount > 0) {
+        WorldDeltaSpan* last = &delta->spans[delta->spanCount - 1];
+
+        if (last->index + last->count == index && last->before == before && last->after == after) {
+            last->count++;
+            return;
+        }
+    }
+
+    if (delta->spanCount == delta->spanCapacity) {
+        delta->spanCapacity = MAX(16, delta->spanCapacity * 2);
+        delta->spans = realloc(delta->spans, delta->spanCapacity * sizeof(WorldDeltaSpan));
+    }
+
+    WorldDeltaSpan* span = &delta->spans[delta->spanCount++];
+    span->index = index;
+    span->count = 1;
+    span->before = before;
+    span->after = after;
+}
+
+void world_delta_trim(WorldDelta* delta) {
+    if (delta->spanCount == delta->spanCapacity)
+        return;
+
+    delta->spanCapacity = delta->spanCount;
+    delta->spans = realloc(delta->spans, delta->spanCapacity * sizeof(WorldDeltaSpan));
+}
+
+void world_delta_absorb(WorldDelta* delta, WorldDelta* newer) {
+    if (newer->spanCount == 0)
+        return;
+
+    if (world_delta_covers(delta, newer) && world_delta_splice(delta, newer))
+        return;
+
+    // Regions grow by at least their own size, so a stroke that keeps
+    // leaving its region only pays for a full merge now and then
+    Box region;
+    box_init(&region);
+
+    int low[3];
+    int high[3];
+    for (int a = 0; a < 3; a++) {
+        low[a] = delta->position[a];
+        high[a] = delta->position[a] + delta->size[a];
+
+        if (newer->position[a] < low[a])
+            low[a] = newer->position[a] - delta->size[a];
+        if (newer->position[a] + newer->size[a] > high[a])
+            high[a] = newer->position[a] + newer->size[a] + delta->size[a];
+    }
+
+    region.position[0] = low[0];
+    region.position[1] = low[1];
+    region.position[2] = low[2];
+
+    region.width = high[0] - low[0];
+    region.height = high[1] - low[1];
+    region.length = high[2] - low[2];
+
+    WorldDelta merged;
+    world_delta_init(&merged, &region);
+    world_delta_combine(&merged, delta, newer);
+
+    world_delta_destroy(delta);
+    *delta = merged;
+}
+
+char world_delta_covers(WorldDelta* delta, WorldDelta* other) {
+    for (int a = 0; a < 3; a++) {
+        if (other->position[a] < delta->position[a] ||
+            other->position[a] + other->size[a] > delta->position[a] + delta->size[a])
+            return 0;
+    }
+
+    return 1;
+}
+
+char world_delta_splice(WorldDelta* delta, WorldDelta* newer) {
+    // Renumber the newer changes in this region; cell order is the same
+    WorldDelta spans = *delta;
+    spans.spans = NULL;
+    spans.spanCount = 0;
+    spans.spanCapacity = 0;
+
+    WorldDeltaCursor cursor;
+    world_delta_cursor_init(&cursor, newer, delta);
+    while (cursor.index >= 0) {
+        WorldDeltaSpan* span = &newer->spans[cursor.span];
+        world_delta_record(&spans, cursor.index, span->before, span->after);
+        world_delta_cursor_next(&cursor, delta);
+    }
+
+    // Cells changed twice need their values combined, which only a full
+    // merge does
+    for (int s = 0; s < spans.spanCount; s++) {
+        WorldDeltaSpan* span = &spans.spans[s];
+        int at = world_delta_search(delta, span->index);
+
+        if ((at > 0 && delta->spans[at - 1].index + delta->spans[at - 1].count > span->index) ||
+            (at < delta->spanCount && delta->spans[at].index < span->index + span->count)) {
+            world_delta_destroy(&spans);
+            return 0;
+        }
+    }
+
+    for (int s = 0; s < spans.spanCount; s++) {
+        WorldDeltaSpan* span = &spans.spans[s];
+        int at = world_delta_search(delta, span->index);
+
+        WorldDeltaSpan* previous = at > 0 ? &delta->spans[at - 1] : NULL;
+        if (previous && previous->index + previous->count == span->index &&
+            previous->before == span->before && previous->after == span->after) {
+            previous->count += span->count;
+            continue;
+        }
+
+        if (delta->spanCount == delta->spanCapacity) {
+            delta->spanCapacity = MAX(16, delta->spanCapacity * 2);
+            delta->spans = realloc(delta->spans, delta->spanCapacity * sizeof(WorldDeltaSpan));
+        }
+
+        memmove(&delta->spans[at + 1], &delta->spans[at], (delta->spanCount - at) * sizeof(WorldDeltaSpan));
+        delta->spans[at] = *span;
+        delta->spanCount++;
+    }
+
+    world_delta_destroy(&spans);
+
+    return 1;
+}
+
+int world_delta_search(WorldDelta* delta, int index) {
+    int low = 0;
+    int high = delta->spanCount;
+
+    // First span that starts after index
+    while (low < high) {
+        int middle = (low + high) / 2;
+
+        if (delta->spans[middle].index <= index) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+void world_delta_combine(WorldDelta* merged, WorldDelta* older, WorldDelta* newer) {
+    // Cells keep the same relative order in any region holding them, so
+    // both span lists can be walked in step like a sorted merge
+    WorldDeltaCursor olderCursor;
+    WorldDeltaCursor newerCursor;
+    world_delta_cursor_init(&olderCursor, older, merged);
+    world_delta_cursor_init(&newerCursor, newer, merged);
+
+    while (olderCursor.index >= 0 || newerCursor.index >= 0) {
+        WorldDeltaSpan* olderSpan = olderCursor.index >= 0 ? &older->spans[olderCursor.span] : NULL;
+        WorldDeltaSpan* newerSpan = newerCursor.index >= 0 ? &newer->spans[newerCursor.span] : NULL;
+        int index;
+        uint16_t before;
+        uint16_t after;
+
+        if (!newerSpan || (olderSpan && olderCursor.index < newerCursor.index)) {
+            index = olderCursor.index;
+            before = olderSpan->before;
+            after = olderSpan->after;
+            world_delta_cursor_next(&olderCursor, merged);
+        } else if (!olderSpan || newerCursor.index < olderCursor.index) {
+            index = newerCursor.index;
+            before = newerSpan->before;
+            after = newerSpan->after;
+            world_delta_cursor_next(&newerCursor, merged);
+        } else {
+            // A cell changed by both keeps its oldest value and its newest one
+            index = olderCursor.index;
+            before = olderSpan->before;
+            after = newerSpan->after;
+            world_delta_cursor_next(&olderCursor, merged);
+            world_delta_cursor_next(&newerCursor, merged);
+        }
+
+        if (before != after)
+            world_delta_record(merged, index, before, after);
+    }
+}
+
+void world_delta_cursor_init(WorldDeltaCursor* cursor, WorldDelta* delta, WorldDelta* target) {
+    cursor->delta = delta;
+    cursor->span = -1;
+    cursor->cell = 0;
+    cursor->index = 0;
+
+    world_delta_cursor_next(cursor, target);
+}
+
+void world_delta_cursor_next(WorldDeltaCursor* cursor, WorldDelta* target) {
+    WorldDelta* delta = cursor->delta;
+
+    if (cursor->span < 0 || ++cursor->cell == delta->spans[cursor->span].count) {
+        cursor->span++;
+        cursor->cell = 0;
+    }
+
+    if (cursor->span == delta->spanCount) {
+        cursor->index = -1;
+        return;
+    }
+
+    int location[3];
+    world_delta_location(delta, delta->spans[cursor->span].index + cursor->cell, location);
+    cursor->index = world_delta_index(target, location);
+}
+
+size_t world_delta_size(WorldDelta* delta) {
+    return sizeof(WorldDelta) + delta->spanCapacity * sizeof(WorldDeltaSpan);
+}
+
+bool world_delta_spill(WorldDelta* delta, FILE* file) {
+    if (delta->spilled || delta->spanCount == 0)
+        return false;
+
+    // The spans stay in memory if they could not all be written
+    if (fwrite(delta->spans, sizeof(WorldDeltaSpan), delta->spanCount, file) != delta->spanCount)
+        return false;
+
+    free(delta->spans);
+    delta->spans = NULL;
+    delta->spanCapacity = 0;
+    delta->spilled = true;
+
+    return true;
+}
+
+bool world_delta_restore(WorldDelta* delta, FILE* file) {
+    if (!delta->spilled)
+        return true;
+
+    WorldDeltaSpan* spans = NEW(WorldDeltaSpan, delta->spanCount);
+
+    // A short read leaves the delta spilled rather than half filled in
+    if (fread(spans, sizeof(WorldDeltaSpan), delta->spanCount, file) != delta->spanCount) {
+        free(spans);
+        return false;
+    }
+
+    delta->spans = spans;
+    delta->spanCapacity = delta->spanCount;
+    delta->spilled = false;
+
+    return true;
+}
@@ -0,0 +1,50 @@
+#ifndef WORLD_DELTA_H
+#define WORLD_DELTA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "global.h"
+#include "box.h"
+
+// A run of consecutive cells that all changed from one block value to another
+typedef struct {
+    int index;
+    int count;
+    uint16_t before;
+    uint16_t after;
+} WorldDeltaSpan;
+
+// The blocks an edit changed inside a region, with cells numbered in the
+// same x, y, z order as chunk blocks; unchanged cells are not stored
+typedef struct {
+    int position[3];
+    int size[3];
+
+    WorldDeltaSpan* spans;
+    int spanCount;
+    int spanCapacity;
+
+    bool spilled;
+} WorldDelta;
+
+WorldDelta* world_delta_init(WorldDelta* d, Box* region);
+void world_delta_destroy(WorldDelta* delta);
+
+int world_delta_index(WorldDelta* delta, int* location);
+int* world_delta_location(WorldDelta* delta, int index, int* location);
+
+void world_delta_record(WorldDelta* delta, int index, uint16_t before, uint16_t after);
+void world_delta_trim(WorldDelta* delta);
+// Folds a later edit into delta, growing its region when needed; cells
+// changed by both keep the oldest before and the newest after
+void world_delta_absorb(WorldDelta* delta, WorldDelta* newer);
+
+size_t world_delta_size(WorldDelta* delta);
+
+bool world_delta_spill(WorldDelta* delta, FILE* file);
+bool world_delta_restore(WorldDelta* delta, FILE* file);
+
+#endif // WORLD_DELTA_H
@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "chunk.h"
+#include "internal/chunk.h"
+
+// Times both mesh paths over world-sized chunks of varying density
+
+#define CHUNKS      64
+#define ROUNDS      20
+#define LENGTH      16
+
+#define FILL_SOLID   0
+#define FILL_TERRAIN 1
+#define FILL_CHECKER 2
+#define FILL_RANDOM  3
+
+typedef void (*MeshFunction)(Chunk*, Chunk**);
+
+static double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec*1e9 + time.tv_nsec;
+}
+
+static void fill_chunk(Chunk* chunk, int pattern) {
+    for (int x=0; x<chunk->width; x++) {
+        for (int y=0; y<chunk->height; y++) {
+            for (int z=0; z<chunk->length; z++) {
+                Block* block = &chunk->blocks[x][y][z];
+                char active;
+
+                switch (pattern) {
+                    case FILL_SOLID:   active = 1; break;
+                    case FILL_TERRAIN: active = y < 6 + (x*3 + z*5) % 5; break;
+                    case FILL_CHECKER: active = (x + y + z) % 2; break;
+                    default:           active = rand() % 4 == 0; break;
+                }
+
+                block->data = 0;
+                if (active) {
+                    block_set_active(block, 1);
+                    block_set_color(block, (rand() % 4) * 97);
+                }
+            }
+        }
+    }
+}
+
+static double chunks_per_second(MeshFunction mesh, Chunk* chunks) {
+    double start = now();
+
+    for (int r=0; r<ROUNDS; r++) {
+        for (int c=0; c<CHUNKS; c++) {
+            mesh_clear(&chunks[c].mesh);
+            mesh(&chunks[c], NULL);
+        }
+    }
+
+    return CHUNKS * ROUNDS / ((now() - start) / 1e9);
+}
+
+static void report(const char* name, int pattern) {
+    Chunk* chunks = malloc(CHUNKS * sizeof(Chunk));
+    for (int c=0; c<CHUNKS; c++) {
+        chunk_init(&chunks[c], LENGTH, LENGTH, LENGTH);
+        fill_chunk(&chunks[c], pattern);
+    }
+
+    // Warm up the quad arrays and scratch so neither path pays for growing them
+    chunks_per_second(chunk_mesh_masks, chunks);
+
+    double masks = chunks_per_second(chunk_mesh_masks, chunks);
+    double binary = chunks_per_second(chunk_mesh_binary, chunks);
+
+    printf("%-10s %12.0f %12.0f %6.2fx\n", name, masks, binary, binary / masks);
+
+    for (int c=0; c<CHUNKS; c++)
+        chunk_destroy(&chunks[c]);
+    free(chunks);
+}
+
+int main() {
+    srand(5);
+
+    printf("%dx%dx%d chunks meshed per second\n", LENGTH, LENGTH, LENGTH);
+    printf("%-10s %12s %12s\n", "", "masks", "binary");
+
+    report("solid", FILL_SOLID);
+    report("terrain", FILL_TERRAIN);
+    report("random", FILL_RANDOM);
+    report("checker", FILL_CHECKER);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chunk.h"
+#include "internal/chunk.h"
+
+// Checks that the bitmask mesher produces exactly the quads of the reference mask mesher
+
+#define FILL_SOLID   0
+#define FILL_HALF    1
+#define FILL_CHECKER 2
+#define FILL_RANDOM  3
+
+static int failures = 0;
+static int cases = 0;
+
+static void fill_chunk(Chunk* chunk, int pattern, int density, int colors) {
+    for (int x=0; x<chunk->width; x++) {
+        for (int y=0; y<chunk->height; y++) {
+            for (int z=0; z<chunk->length; z++) {
+                Block* block = &chunk->blocks[x][y][z];
+                char active;
+
+                switch (pattern) {
+                    case FILL_SOLID:   active = 1; break;
+                    case FILL_HALF:    active = y < chunk->height/2; break;
+                    case FILL_CHECKER: active = (x + y + z) % 2; break;
+                    default:           active = density && rand() % density == 0; break;
+                }
+
+                block->data = 0;
+                if (active) {
+                    block_set_active(block, 1);
+                    block_set_color(block, (rand() % colors) * 97);
+                }
+            }
+        }
+    }
+}
+
+static void compare_meshers(const char* name, Chunk* chunk, Chunk** neighbors) {
+    mesh_clear(&chunk->mesh);
+    chunk_mesh_masks(chunk, neighbors);
+
+    int slices = chunk_slice_count(chunk);
+    int* offsets = malloc(slices * sizeof(int));
+    memcpy(offsets, chunk->sliceOffsets, slices * sizeof(int));
+
+    int count = chunk->mesh.quads.size;
+    Quad* quads = malloc((count + 1) * sizeof(Quad));
+    // An empty mesh may not have allocated any quad storage yet
+    if (count)
+        memcpy(quads, chunk->mesh.quads.data, count * sizeof(Quad));
+
+    mesh_clear(&chunk->mesh);
+    chunk_mesh_binary(chunk, neighbors);
+
+    char equal = count == chunk->mesh.quads.size &&
+                 !memcmp(offsets, chunk->sliceOffsets, slices * sizeof(int));
+
+    for (int i=0; equal && i<count; i++) {
+        Quad* a = &quads[i];
+        Quad* b = &chunk->mesh.quads.data[i];
+
+        if (a->orientation != b->orientation || a->color != b->color)
+            equal = 0;
+
+        for (int v=0; v<4; v++)
+            if (memcmp(a->vertices[v].position, b->vertices[v].position, sizeof(a->vertices[v].position)))
+                equal = 0;
+    }
+
+    cases++;
+    if (!equal) {
+        failures++;
+        printf("FAIL %s %dx%dx%d: %d quads from masks, %d from binary\n", name,
+               chunk->width, chunk->height, chunk->length, count, chunk->mesh.quads.size);
+    }
+
+    free(quads);
+    free(offsets);
+}
+
+static void test_size(int width, int height, int length, int rounds) {
+    for (int r=0; r<rounds; r++) {
+        Chunk chunk;
+        Chunk neighborChunks[6];
+        Chunk* neighbors[6];
+
+        chunk_init(&chunk, width, height, length);
+        fill_chunk(&chunk, r % 4, 1 + rand() % 5, 1 + rand() % 3);
+
+        for (int f=0; f<6; f++) {
+            chunk_init(&neighborChunks[f], width, height, length);
+            fill_chunk(&neighborChunks[f], rand() % 4, 1 + rand() % 5, 2);
+            neighbors[f] = rand() % 4 ? &neighborChunks[f] : NULL;
+        }
+
+        compare_meshers("random", &chunk, neighbors);
+        compare_meshers("isolated", &chunk, NULL);
+
+        for (int f=0; f<6; f++)
+            chunk_destroy(&neighborChunks[f]);
+        chunk_destroy(&chunk);
+    }
+}
+
+static void test_edge_cases() {
+    Chunk chunk;
+    Chunk solid;
+    chunk_init(&chunk, 16, 16, 16);
+    chunk_init(&solid, 16, 16, 16);
+    fill_chunk(&solid, FILL_SOLID, 0, 1);
+
+    Chunk* enclosed[6] = {&solid, &solid, &solid, &solid, &solid, &solid};
+
+    fill_chunk(&chunk, FILL_RANDOM, 0, 1);
+    compare_meshers("empty", &chunk, enclosed);
+
+    fill_chunk(&chunk, FILL_SOLID, 0, 1);
+    compare_meshers("enclosed solid", &chunk, enclosed);
+    compare_meshers("isolated solid", &chunk, NULL);
+
+    fill_chunk(&chunk, FILL_CHECKER, 0, 4);
+    compare_meshers("checker", &chunk, enclosed);
+
+    chunk_destroy(&solid);
+    chunk_destroy(&chunk);
+}
+
+int main() {
+    srand(7);
+
+    test_edge_cases();
+
+    test_size(16, 16, 16, 20);
+    test_size(32, 32, 32, 10);
+    test_size(1, 1, 1, 20);
+    test_size(5, 17, 3, 20);
+    test_size(64, 1, 33, 10);
+    test_size(2, 64, 7, 10);
+    test_size(64, 64, 64, 4);
+
+    printf("chunk_mesh_test: %d/%d identical\n", cases - failures, cases);
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
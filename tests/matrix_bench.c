@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "matrix.h"
+#include "matrix_reference.h"
+
+// Times matrix.c against the original scalar routines
+
+#define ITERATIONS 1000000
+
+typedef float* (*MatrixFunction)(float*, float*, float*);
+
+static double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec*1e9 + time.tv_nsec;
+}
+
+static double time_inverse(float* (*inverse)(float*, float*), float* mat4) {
+    float result[16];
+    volatile float sink = 0;
+
+    double start = now();
+    for (int i=0; i<ITERATIONS; i++) {
+        mat4[0] += 1e-7f;
+        inverse(result, mat4);
+        sink += result[0];
+    }
+
+    return (now() - start) / ITERATIONS;
+}
+
+static double time_product(MatrixFunction product, float* mat4, float* operand) {
+    float result[16];
+    volatile float sink = 0;
+
+    double start = now();
+    for (int i=0; i<ITERATIONS; i++) {
+        operand[0] += 1e-7f;
+        product(result, mat4, operand);
+        sink += result[0];
+    }
+
+    return (now() - start) / ITERATIONS;
+}
+
+static void report(const char* name, double reference, double current) {
+    printf("%-16s %8.1f ns %8.1f ns %6.2fx\n", name, reference, current, reference / current);
+}
+
+int main() {
+    float view[16], other[16];
+    float vec4[4] = {1, 2, 3, 1};
+    float axis[3] = {0.3, 0.8, 0.5};
+    float offset[3] = {12, -40, 7};
+
+    mat4_rotate(view, NULL, 0.7, axis);
+    mat4_translate(view, view, offset);
+    for (int i=0; i<16; i++)
+        other[i] = (i * 7 % 11) / 11.0f;
+
+    printf("%-16s %11s %11s\n", "", "reference", "current");
+
+    report("mat4_inverse", time_inverse(reference_mat4_inverse, view),
+                           time_inverse(mat4_inverse, view));
+    report("mat4_multiply", time_product(reference_mat4_multiply, view, other),
+                            time_product(mat4_multiply, view, other));
+    report("vec4_transform", time_product(reference_vec4_transform, view, vec4),
+                             time_product(vec4_transform, view, vec4));
+    report("vec3_transform", time_product(reference_vec3_transform, view, vec4),
+                             time_product(vec3_transform, view, vec4));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,174 @@
+#include "matrix_reference.h"
+
+static float reference_mat2_determinate(float* mat2s) {
+    return (mat2s[0] * mat2s[3]) - (mat2s[1] * mat2s[2]);
+}
+
+static float* reference_mat3_sub(float* mat2d, float* mat3s, unsigned int i) {
+    float* mat2 = mat2d ? mat2d : NEW(float, 4);
+
+    int indices[4] = {4, 5, 7, 8};
+
+    unsigned int c = i / 3;
+    for (unsigned int x=0; x<c; x++) {
+        indices[x*2+0] -= 3;
+        indices[x*2+1] -= 3;
+    }
+
+    unsigned int r = i % 3;
+    for (unsigned int x=0; x<r; x++) {
+        indices[x*1+0] -= 1;
+        indices[x*1+2] -= 1;
+    }
+
+    for (unsigned int x=0; x<4; x++) {
+        mat2[x] = mat3s[indices[x]];
+    }
+
+    return mat2;
+}
+
+static float reference_mat3_determinate(float* mat3s) {
+    float vec[3];
+    float mat2[4];
+
+    for (unsigned i=0; i<3; i++) {
+        reference_mat3_sub(mat2, mat3s, i);
+        vec[i] = reference_mat2_determinate(mat2);
+    }
+
+    float det = mat3s[0]*vec[0] - mat3s[1]*vec[1] + mat3s[2]*vec[2];
+
+    return det;
+}
+
+static float* reference_mat4_sub(float* mat3d, float* mat4s, unsigned int i) {
+    float* mat3 = mat3d ? mat3d : NEW(float, 9);
+
+    int indices[9] = {5, 6, 7, 9, 10, 11, 13, 14, 15};
+
+    unsigned int c = i / 4;
+    for (unsigned int x=0; x<c; x++) {
+        indices[x*3+0] -= 4;
+        indices[x*3+1] -= 4;
+        indices[x*3+2] -= 4;
+    }
+
+    unsigned int r = i % 4;
+    for (unsigned int x=0; x<r; x++) {
+        indices[x*1+0] -= 1;
+        indices[x*1+3] -= 1;
+        indices[x*1+6] -= 1;
+    }
+
+    for (unsigned int x=0; x<9; x++) {
+        mat3[x] = mat4s[indices[x]];
+    }
+
+    return mat3;
+}
+
+static float* reference_mat4_transpose(float* mat4d, float* mat4s) {
+    float* mat4t = NEW(float, 16);
+
+    for (unsigned i=0; i<4; i++)
+        for (unsigned j=0; j<4; j++)
+            mat4t[i*4+j] = mat4s[j*4+i];
+
+    if (mat4d) {
+        memcpy(mat4d, mat4t, 16*sizeof(float));
+        free(mat4t);
+    } else {
+        mat4d = mat4t;
+    }
+
+    return mat4d;
+}
+
+float* reference_mat4_inverse(float* mat4d, float* mat4s) {
+    float* mat4m = NEW(float, 16);
+    float  mat3[9];
+
+    for (unsigned i=0; i<16; i++) {
+        reference_mat4_sub(mat3, mat4s, i);
+        mat4m[i] = reference_mat3_determinate(mat3);
+    }
+
+    float det = mat4s[0]*mat4m[0] - mat4s[1]*mat4m[1] + mat4s[2]*mat4m[2] - mat4s[3]*mat4m[3];
+
+    // Cofactors
+    for (unsigned i=0; i<16; i++) {
+        if ((i / 4) % 2 == 1)
+            if (i % 2 == 0)
+                mat4m[i] = -mat4m[i];
+
+        if ((i / 4) % 2 == 0)
+            if (i % 2 == 1)
+                mat4m[i] = -mat4m[i];
+    }
+
+    // Adjugate
+    reference_mat4_transpose(mat4m, mat4m);
+
+    // Multiply by 1/Determinant
+    for (unsigned i=0; i<16; i++)
+        mat4m[i] /= det;
+
+    if (mat4d) {
+        memcpy(mat4d, mat4m, 16*sizeof(float));
+        free(mat4m);
+    } else {
+        mat4d = mat4m;
+    }
+
+    return mat4d;
+}
+
+float* reference_mat4_multiply(float* mat4d, float* mat4a, float* mat4b) {
+    float* mat4m = NEW(float, 16);
+
+    for (unsigned i=0; i<4; i++)
+        for (unsigned j=0; j<4; j++)
+            mat4m[i*4+j] = mat4a[0+j]*mat4b[i*4+0] + mat4a[4+j]*mat4b[i*4+1] + mat4a[8+j]*mat4b[i*4+2]  + mat4a[12+j]*mat4b[i*4+3];
+
+    if (mat4d) {
+        memcpy(mat4d, mat4m, 16*sizeof(float));
+        free(mat4m);
+    } else {
+        mat4d = mat4m;
+    }
+
+    return mat4d;
+}
+
+float* reference_vec3_transform(float* vec3d, float* mat4, float* vec3s) {
+    float* vec3t  = NEW(float, 3);
+
+    for (unsigned i=0; i<3; i++)
+        vec3t[i] = vec3s[0]*mat4[i+0] + vec3s[1]*mat4[i+4] + vec3s[2]*mat4[i+8] + mat4[i+12];
+
+    if (vec3d) {
+        memcpy(vec3d, vec3t, 3*sizeof(float));
+        free(vec3t);
+    } else {
+        vec3d = vec3t;
+    }
+
+    return vec3d;
+}
+
+float* reference_vec4_transform(float* vec4d, float* mat4, float* vec4s) {
+    float* vec4t  = NEW(float, 4);
+
+    for (unsigned i=0; i<4; i++)
+        vec4t[i] = vec4s[0]*mat4[i+0] + vec4s[1]*mat4[i+4] + vec4s[2]*mat4[i+8] + vec4s[3]*mat4[i+12];
+
+    if (vec4d) {
+        memcpy(vec4d, vec4t, 4*sizeof(float));
+        free(vec4t);
+    } else {
+        vec4d = vec4t;
+    }
+
+    return vec4d;
+}
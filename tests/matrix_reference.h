@@ -0,0 +1,13 @@
+#ifndef MATRIX_REFERENCE_H
+#define MATRIX_REFERENCE_H
+
+#include "matrix.h"
+
+// The original scalar matrix routines, kept as the yardstick for matrix.c
+
+float* reference_mat4_inverse(float* mat4d, float* mat4s);
+float* reference_mat4_multiply(float* mat4d, float* mat4a, float* mat4b);
+float* reference_vec3_transform(float* vec3d, float* mat4, float* vec3s);
+float* reference_vec4_transform(float* vec4d, float* mat4, float* vec4s);
+
+#endif // MATRIX_REFERENCE_H
@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "matrix.h"
+#include "matrix_reference.h"
+
+// Compares matrix.c against the original scalar routines on camera-like and random matrices
+
+#define ROUNDS 100000
+
+#define INVERSE_TOLERANCE   1e-3
+#define PRODUCT_TOLERANCE   1e-5
+
+static int failures = 0;
+
+static float random_unit() {
+    return (rand() / (float)RAND_MAX) * 2 - 1;
+}
+
+static double relative_error(float* a, float* b, int n) {
+    double error = 0;
+
+    for (int i=0; i<n; i++)
+        error = fmax(error, fabs(a[i] - b[i]) / (fabs(a[i]) + 1));
+
+    return error;
+}
+
+static void check(const char* name, double error, double tolerance) {
+    printf("%-16s max relative error %.3g\n", name, error);
+
+    if (!(error <= tolerance)) {
+        failures++;
+        printf("FAIL %s exceeds %.3g\n", name, tolerance);
+    }
+}
+
+static void random_view(float* mat4) {
+    float axis[3] = {random_unit(), random_unit(), random_unit()};
+    float offset[3] = {random_unit()*100, random_unit()*100, random_unit()*100};
+
+    mat4_rotate(mat4, NULL, random_unit()*3, axis);
+    mat4_translate(mat4, mat4, offset);
+
+    if (rand() % 2) {
+        float projection[16];
+        mat4_perspective(projection, 60 + random_unit()*30, 1.5, 0.1, 500);
+        mat4_multiply(mat4, projection, mat4);
+    }
+}
+
+static void test_accuracy() {
+    float view[16], other[16], expected[16], actual[16];
+    float vec4[4], expectedVec[4], actualVec[4];
+    double inverseError = 0, multiplyError = 0, vec4Error = 0, vec3Error = 0;
+
+    for (int r=0; r<ROUNDS; r++) {
+        random_view(view);
+        for (int i=0; i<16; i++)
+            other[i] = random_unit();
+        for (int i=0; i<4; i++)
+            vec4[i] = random_unit()*10;
+
+        reference_mat4_inverse(expected, view);
+        mat4_inverse(actual, view);
+        inverseError = fmax(inverseError, relative_error(expected, actual, 16));
+
+        reference_mat4_multiply(expected, view, other);
+        mat4_multiply(actual, view, other);
+        multiplyError = fmax(multiplyError, relative_error(expected, actual, 16));
+
+        reference_vec4_transform(expectedVec, view, vec4);
+        vec4_transform(actualVec, view, vec4);
+        vec4Error = fmax(vec4Error, relative_error(expectedVec, actualVec, 4));
+
+        reference_vec3_transform(expectedVec, other, vec4);
+        vec3_transform(actualVec, other, vec4);
+        vec3Error = fmax(vec3Error, relative_error(expectedVec, actualVec, 3));
+    }
+
+    check("mat4_inverse", inverseError, INVERSE_TOLERANCE);
+    check("mat4_multiply", multiplyError, PRODUCT_TOLERANCE);
+    check("vec4_transform", vec4Error, PRODUCT_TOLERANCE);
+    check("vec3_transform", vec3Error, PRODUCT_TOLERANCE);
+}
+
+static void test_aliasing() {
+    float view[16], other[16], expected[16], actual[16];
+    float vec4[4], expectedVec[4];
+    double error = 0;
+
+    for (int r=0; r<1000; r++) {
+        random_view(view);
+        random_view(other);
+        for (int i=0; i<4; i++)
+            vec4[i] = random_unit()*10;
+
+        // Destination shared with either operand
+        reference_mat4_multiply(expected, view, other);
+        memcpy(actual, view, sizeof(actual));
+        mat4_multiply(actual, actual, other);
+        error = fmax(error, relative_error(expected, actual, 16));
+
+        memcpy(actual, other, sizeof(actual));
+        mat4_multiply(actual, view, actual);
+        error = fmax(error, relative_error(expected, actual, 16));
+
+        reference_mat4_inverse(expected, view);
+        memcpy(actual, view, sizeof(actual));
+        mat4_inverse(actual, actual);
+        error = fmax(error, relative_error(expected, actual, 16));
+
+        reference_vec4_transform(expectedVec, view, vec4);
+        vec4_transform(vec4, view, vec4);
+        error = fmax(error, relative_error(expectedVec, vec4, 4));
+
+        reference_vec3_transform(expectedVec, view, vec4);
+        vec3_transform(vec4, view, vec4);
+        error = fmax(error, relative_error(expectedVec, vec4, 3));
+    }
+
+    check("in place", error, INVERSE_TOLERANCE);
+
+    // A NULL destination still allocates the result
+    float* allocated = mat4_multiply(NULL, view, other);
+    reference_mat4_multiply(expected, view, other);
+    check("allocated", relative_error(expected, allocated, 16), PRODUCT_TOLERANCE);
+    free(allocated);
+}
+
+static void test_identity() {
+    float view[16], inverse[16], product[16];
+    double error = 0;
+
+    for (int r=0; r<1000; r++) {
+        random_view(view);
+        mat4_inverse(inverse, view);
+        mat4_multiply(product, view, inverse);
+
+        for (int i=0; i<16; i++)
+            error = fmax(error, fabs(product[i] - (i % 5 == 0)));
+    }
+
+    check("A * inverse(A)", error, INVERSE_TOLERANCE);
+}
+
+int main() {
+    srand(3);
+
+    test_accuracy();
+    test_aliasing();
+    test_identity();
+
+    printf("matrix_test: %s\n", failures ? "FAILED" : "passed");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}